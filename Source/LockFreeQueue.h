@@ -0,0 +1,205 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define LOCKFREEQUEUE_CACHE_LINE_SIZE 64
+
+/**
+	Fixed-capacity, wait-free single-producer/single-consumer ring buffer.
+
+	All storage is allocated in the constructor; push() and pop() never
+	allocate, lock or move existing elements. Exactly one thread may call
+	the producer methods (push) and exactly one thread may call the
+	consumer methods (pop, front, clear) at any given time.
+
+	When the ring is full, push() drops the new element and increments
+	the overflow counter instead of growing.
+*/
+template <typename T>
+class LockFreeQueue
+{
+public:
+
+	/** Constructor -- capacity is rounded up to the next power of two */
+	explicit LockFreeQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		m_mask = size - 1;
+		m_buffer.reset(new T[size]);
+	}
+
+	/** Destructor */
+	~LockFreeQueue() { }
+
+	/** Producer: adds an element, returns false (and counts a drop) if the queue is full */
+	bool push(const T& element)
+	{
+		const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+		if (head - m_cachedTail > m_mask)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+			if (head - m_cachedTail > m_mask)
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		m_buffer[head & m_mask] = element;
+		m_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/** Consumer: removes the oldest element, returns false if the queue is empty */
+	bool pop(T& element)
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		if (tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+
+			if (tail == m_cachedHead)
+				return false;
+		}
+
+		element = m_buffer[tail & m_mask];
+		m_tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/** Consumer: returns the oldest element without removing it, or nullptr if the queue is empty */
+	const T* front()
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		if (tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+
+			if (tail == m_cachedHead)
+				return nullptr;
+		}
+
+		return &m_buffer[tail & m_mask];
+	}
+
+	/** Consumer: discards all elements currently in the queue */
+	void clear()
+	{
+		m_cachedHead = m_head.load(std::memory_order_acquire);
+		m_tail.store(m_cachedHead, std::memory_order_release);
+	}
+
+	/** True if the queue is empty (approximate when called concurrently) */
+	bool isEmpty() const
+	{
+		return count() == 0;
+	}
+
+	/** Returns the number of elements available (approximate when called concurrently) */
+	std::size_t count() const
+	{
+		return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+	}
+
+	/** Returns the maximum number of elements the queue can hold */
+	std::size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+	/** Returns the number of elements dropped because the queue was full */
+	uint64_t getDroppedCount() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
+	/** Resets the overflow counter */
+	void resetDroppedCount()
+	{
+		m_dropped.store(0, std::memory_order_relaxed);
+	}
+
+private:
+
+	// producer-owned cache line
+	alignas(LOCKFREEQUEUE_CACHE_LINE_SIZE) std::atomic<std::size_t> m_head { 0 };
+	std::size_t m_cachedTail = 0;
+
+	// consumer-owned cache line
+	alignas(LOCKFREEQUEUE_CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail { 0 };
+	std::size_t m_cachedHead = 0;
+
+	alignas(LOCKFREEQUEUE_CACHE_LINE_SIZE) std::atomic<uint64_t> m_dropped { 0 };
+
+	std::size_t m_mask = 0;
+	std::unique_ptr<T[]> m_buffer;
+
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+};
+
+/**
+	Merges several queues: pops the element that orders first by key()
+	among the elements at the front of the queues in [first, last), which
+	point to LockFreeQueue<T>s consumed by the calling thread. Returns
+	false if all of them are empty.
+
+	When each queue is ordered by key() (e.g. arrival time), repeated calls
+	return the queued elements in key order.
+*/
+template <typename QueueIterator, typename T, typename Key>
+bool popEarliest(QueueIterator first, QueueIterator last, T& element, Key&& key)
+{
+	QueueIterator earliest = last;
+	const T* earliestElement = nullptr;
+
+	for (QueueIterator queue = first; queue != last; ++queue)
+	{
+		const T* front = (*queue)->front();
+
+		if (front != nullptr && (earliestElement == nullptr || key(*front) < key(*earliestElement)))
+		{
+			earliest = queue;
+			earliestElement = front;
+		}
+	}
+
+	return earliest != last && (*earliest)->pop(element);
+}
+
+#endif
@@ -0,0 +1,238 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCAddressMatcher.h"
+
+#include <map>
+
+OSCAddressMatcher::OSCAddressMatcher(bool caseSensitive)
+    : m_caseSensitive(caseSensitive)
+{
+}
+
+int OSCAddressMatcher::addAddress(const std::string& address)
+{
+    std::string folded;
+    for (char c : address)
+        folded += fold(c);
+
+    for (int i = 0; i < (int) m_addresses.size(); i++)
+    {
+        std::string existing;
+        for (char c : m_addresses[i])
+            existing += fold(c);
+
+        if (existing == folded)
+            return i;
+    }
+
+    m_addresses.push_back(address);
+    return (int) m_addresses.size() - 1;
+}
+
+void OSCAddressMatcher::clear()
+{
+    m_addresses.clear();
+    m_nodes.clear();
+    m_edgeLabels.clear();
+    m_edgeTargets.clear();
+    m_matchStamps.clear();
+    m_visitStamps.clear();
+}
+
+void OSCAddressMatcher::compile()
+{
+    // build a pointer-free tree first...
+    struct BuildNode
+    {
+        std::map<char, int> children;
+        int addressIndex = -1;
+    };
+
+    std::vector<BuildNode> tree(1);
+
+    for (int i = 0; i < (int) m_addresses.size(); i++)
+    {
+        int node = 0;
+
+        for (char c : m_addresses[i])
+        {
+            char label = fold(c);
+            auto it = tree[node].children.find(label);
+
+            if (it == tree[node].children.end())
+            {
+                tree.push_back(BuildNode());
+                int child = (int) tree.size() - 1;
+                tree[node].children[label] = child;
+                node = child;
+            }
+            else
+            {
+                node = it->second;
+            }
+        }
+
+        tree[node].addressIndex = i;
+    }
+
+    // ...then flatten it breadth-first, so every node's edges are contiguous and sorted
+    m_nodes.assign(tree.size(), Node());
+    m_edgeLabels.clear();
+    m_edgeTargets.clear();
+
+    std::vector<int> order(1, 0);
+    std::vector<int> flatIndex(tree.size(), -1);
+    flatIndex[0] = 0;
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const BuildNode& source = tree[order[i]];
+        Node& node = m_nodes[i];
+
+        node.firstEdge = (int32_t) m_edgeLabels.size();
+        node.numEdges = (int32_t) source.children.size();
+        node.addressIndex = source.addressIndex;
+
+        for (auto& child : source.children)
+        {
+            flatIndex[child.second] = (int) order.size();
+            order.push_back(child.second);
+
+            m_edgeLabels.push_back(child.first);
+            m_edgeTargets.push_back(flatIndex[child.second]);
+        }
+    }
+
+    m_matchStamps.assign(m_addresses.size(), 0u);
+    m_visitStamps.assign(m_nodes.size() * (2 * MAX_PATTERN_WILDCARDS), 0u);
+    m_generation = 0;
+}
+
+int OSCAddressMatcher::findChild(int node, char label) const
+{
+    const Node& n = m_nodes[node];
+
+    // edges are sorted by label
+    int lo = n.firstEdge;
+    int hi = n.firstEdge + n.numEdges;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if (m_edgeLabels[mid] < label)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < n.firstEdge + n.numEdges && m_edgeLabels[lo] == label)
+        return m_edgeTargets[lo];
+
+    return -1;
+}
+
+int OSCAddressMatcher::findExact(const char* address) const
+{
+    if (m_nodes.empty())
+        return -1;
+
+    int node = 0;
+
+    for (const char* p = address; *p && node >= 0; p++)
+        node = findChild(node, fold(*p));
+
+    return node >= 0 ? m_nodes[node].addressIndex : -1;
+}
+
+bool OSCAddressMatcher::bracketMatches(const char* first, const char* last, char c) const
+{
+    bool negate = false;
+
+    if (first < last && *first == '!')
+    {
+        negate = true;
+        first++;
+    }
+
+    bool found = false;
+
+    for (const char* p = first; p < last && !found; p++)
+    {
+        if (p + 2 < last && p[1] == '-')
+        {
+            char lo = fold(p[0]);
+            char hi = fold(p[2]);
+            found = (c >= lo && c <= hi);
+            p += 2;
+        }
+        else
+        {
+            found = (c == fold(*p));
+        }
+    }
+
+    return found != negate;
+}
+
+int OSCAddressMatcher::countWildcards(const char* pattern)
+{
+    int count = 0;
+
+    for (const char* p = pattern; *p; p++)
+    {
+        switch (*p)
+        {
+        case '*':
+            while (p[1] == '*')
+                p++;
+            count++;
+            break;
+
+        case '?':
+            count++;
+            break;
+
+        case '[':
+        case '{':
+        {
+            const char close = (*p == '[') ? ']' : '}';
+
+            while (p[1] && p[1] != close)
+                p++;
+
+            if (!p[1]) // unterminated: matching stops here anyway
+                return count + 1;
+
+            p++;
+            count++;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,265 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCADDRESSMATCHER_H
+#define OSCADDRESSMATCHER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define MAX_PATTERN_WILDCARDS 32
+
+/**
+	Matches incoming OSC address patterns against a set of registered
+	method addresses.
+
+	Addresses are compiled into a flat, sorted trie. Incoming patterns may
+	use the OSC 1.0 wildcards '?', '*', '[...]' (with ranges and '!'
+	negation) and '{a,b,...}'; plain addresses are resolved in
+	O(address length) regardless of how many addresses are registered.
+	match() never allocates.
+
+	Wildcards are matched without exponential backtracking: every
+	(trie node, wildcard) state is expanded at most once per match, so a
+	pattern costs at most O(trie size x wildcards). Patterns with more than
+	MAX_PATTERN_WILDCARDS wildcards match nothing.
+
+	addAddress() and compile() must be called before matching; match() may
+	then be called from a single thread (typically the OSC listener).
+*/
+class OSCAddressMatcher
+{
+public:
+
+	/** Constructor */
+	explicit OSCAddressMatcher(bool caseSensitive = true);
+
+	/** Destructor */
+	~OSCAddressMatcher() { }
+
+	/** Registers a method address, returns its index (existing index for duplicates) */
+	int addAddress(const std::string& address);
+
+	/** Builds the trie from the registered addresses */
+	void compile();
+
+	/** Removes all addresses */
+	void clear();
+
+	/** Returns the number of registered addresses */
+	int getNumAddresses() const { return (int) m_addresses.size(); }
+
+	/** Returns a registered address */
+	const std::string& getAddress(int index) const { return m_addresses[index]; }
+
+	/** Returns the index of the address equal to a literal (wildcard-free) address, or -1 */
+	int findExact(const char* address) const;
+
+	/** Calls callback(int index) once for every registered address matched by an
+		OSC address pattern, and returns the number of matches */
+	template <typename Callback>
+	int match(const char* pattern, Callback&& callback)
+	{
+		if (m_nodes.empty())
+			return 0;
+
+		if (countWildcards(pattern) > MAX_PATTERN_WILDCARDS)
+			return 0;
+
+		if (++m_generation == 0) // wrapped around: reset stamps
+		{
+			std::fill(m_matchStamps.begin(), m_matchStamps.end(), 0u);
+			std::fill(m_visitStamps.begin(), m_visitStamps.end(), 0u);
+			m_generation = 1;
+		}
+
+		int numMatches = 0;
+		matchFrom(0, pattern, 0, callback, numMatches);
+		return numMatches;
+	}
+
+private:
+
+	struct Node
+	{
+		int32_t firstEdge;
+		int32_t numEdges;
+		int32_t addressIndex; // -1 if no address ends at this node
+	};
+
+	char fold(char c) const
+	{
+		return (!m_caseSensitive && c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+	}
+
+	/** Returns the child of node along label, or -1 */
+	int findChild(int node, char label) const;
+
+	/** True if c is accepted by the bracket expression [first, last) */
+	bool bracketMatches(const char* first, const char* last, char c) const;
+
+	/** Returns the number of wildcards in a pattern, counting a run of '*' once */
+	static int countWildcards(const char* pattern);
+
+	template <typename Callback>
+	void emit(int node, Callback& callback, int& numMatches)
+	{
+		int index = m_nodes[node].addressIndex;
+
+		if (index < 0 || m_matchStamps[index] == m_generation)
+			return;
+
+		m_matchStamps[index] = m_generation;
+		numMatches++;
+		callback(index);
+	}
+
+	/** Continues matching from a wildcard state, unless this match already has:
+		state is 2 x wildcard for "on a '*'" and 2 x wildcard + 1 for "after a wildcard",
+		which together with the node determine the pattern position */
+	template <typename Callback>
+	void visit(int node, const char* p, int wildcard, int state, Callback& callback, int& numMatches)
+	{
+		uint32_t& stamp = m_visitStamps[(size_t) node * (2 * MAX_PATTERN_WILDCARDS) + state];
+
+		if (stamp == m_generation)
+			return;
+
+		stamp = m_generation;
+		matchFrom(node, p, wildcard, callback, numMatches);
+	}
+
+	/** wildcard is the index of the next wildcard in the pattern */
+	template <typename Callback>
+	void matchFrom(int node, const char* p, int wildcard, Callback& callback, int& numMatches)
+	{
+		for (;;)
+		{
+			const char c = *p;
+			const Node& n = m_nodes[node];
+
+			switch (c)
+			{
+			case '\0':
+				emit(node, callback, numMatches);
+				return;
+
+			case '?':
+				for (int e = n.firstEdge; e < n.firstEdge + n.numEdges; e++)
+				{
+					if (m_edgeLabels[e] != '/')
+						visit(m_edgeTargets[e], p + 1, wildcard + 1, 2 * wildcard + 1, callback, numMatches);
+				}
+				return;
+
+			case '*':
+				while (p[1] == '*')
+					p++;
+
+				// match zero characters, or consume one and stay on the '*'
+				visit(node, p + 1, wildcard + 1, 2 * wildcard + 1, callback, numMatches);
+
+				for (int e = n.firstEdge; e < n.firstEdge + n.numEdges; e++)
+				{
+					if (m_edgeLabels[e] != '/')
+						visit(m_edgeTargets[e], p, wildcard, 2 * wildcard, callback, numMatches);
+				}
+				return;
+
+			case '[':
+			{
+				const char* last = p + 1;
+				while (*last && *last != ']')
+					last++;
+
+				if (!*last) // unterminated bracket expression
+					return;
+
+				for (int e = n.firstEdge; e < n.firstEdge + n.numEdges; e++)
+				{
+					if (m_edgeLabels[e] != '/' && bracketMatches(p + 1, last, m_edgeLabels[e]))
+						visit(m_edgeTargets[e], last + 1, wildcard + 1, 2 * wildcard + 1, callback, numMatches);
+				}
+				return;
+			}
+
+			case '{':
+			{
+				const char* last = p + 1;
+				while (*last && *last != '}')
+					last++;
+
+				if (!*last) // unterminated alternatives
+					return;
+
+				const char* alternative = p + 1;
+
+				while (alternative <= last)
+				{
+					int child = node;
+					const char* q = alternative;
+
+					for (; q < last && *q != ','; q++)
+					{
+						if (child >= 0)
+							child = findChild(child, fold(*q));
+					}
+
+					if (child >= 0)
+						visit(child, last + 1, wildcard + 1, 2 * wildcard + 1, callback, numMatches);
+
+					alternative = q + 1;
+				}
+				return;
+			}
+
+			default:
+				node = findChild(node, fold(c));
+
+				if (node < 0)
+					return;
+
+				p++;
+			}
+		}
+	}
+
+	bool m_caseSensitive;
+
+	std::vector<std::string> m_addresses;
+
+	// compiled trie: node 0 is the root, the edges of each node are contiguous and sorted by label
+	std::vector<Node> m_nodes;
+	std::vector<char> m_edgeLabels;
+	std::vector<int32_t> m_edgeTargets;
+
+	// per-address generation stamps, so wildcards that reach the same address twice report it once
+	std::vector<uint32_t> m_matchStamps;
+
+	// per (node, wildcard state) generation stamps, so each state is expanded once per match
+	std::vector<uint32_t> m_visitStamps;
+	uint32_t m_generation = 0;
+};
+
+#endif
@@ -23,6 +23,38 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "OSCEvents.h"
 #include "OSCEventsEditor.h"
 
+/** Value and text routes take int32, int64, float and double arguments as numbers */
+static bool isNumber(const osc::ReceivedMessageArgument& argument)
+{
+    return argument.IsFloat() || argument.IsInt32() || argument.IsDouble() || argument.IsInt64();
+}
+
+static double toDouble(const osc::ReceivedMessageArgument& argument)
+{
+    if (argument.IsFloat())
+        return argument.AsFloatUnchecked();
+    else if (argument.IsInt32())
+        return argument.AsInt32Unchecked();
+    else if (argument.IsDouble())
+        return argument.AsDoubleUnchecked();
+    else
+        return (double) argument.AsInt64Unchecked();
+}
+
+/** Text routes take string and symbol arguments as text */
+static bool isText(const osc::ReceivedMessageArgument& argument)
+{
+    return argument.IsString() || argument.IsSymbol();
+}
+
+static bool hasText(const osc::ReceivedMessage& message)
+{
+    for (auto argument = message.ArgumentsBegin(); argument != message.ArgumentsEnd(); ++argument)
+        if (isText(*argument))
+            return true;
+
+    return false;
+}
 
 OSCEventsNode::OSCEventsNode()
     : GenericProcessor("OSC Events")
@@ -31,8 +63,40 @@ OSCEventsNode::OSCEventsNode()
     addIntParameter(Parameter::GLOBAL_SCOPE, "Port", "OSC Port Number", DEFAULT_PORT, 1024, 49151);
     addIntParameter(Parameter::GLOBAL_SCOPE, "Duration", "TTL Pulse Duration (ms)", 50, 0, 5000);
     addStringParameter(Parameter::GLOBAL_SCOPE, "Address", "OSC Address", DEFAULT_OSC_ADDRESS);
+    addIntParameter(Parameter::GLOBAL_SCOPE, "Threads", "Listener threads sharing the port (Linux only)",
+                    1, 1, MAX_LISTENER_THREADS, true);
+    addStringParameter(Parameter::GLOBAL_SCOPE, "Cores", "CPU cores the listener threads are pinned to, e.g. '2,3'", "", true);
+    addStringParameter(Parameter::GLOBAL_SCOPE, "Routes",
+                       "Additional OSC routes, separated by ';': <address> line=<n> stream=<n> duration=<ms> mode=pulse|state|on|off|value|text channel=<n> interp=hold|linear",
+                       "");
+    addIntParameter(Parameter::GLOBAL_SCOPE, "Values", "Continuous channels added to each stream for mode=value routes",
+                    0, 0, MAX_VALUE_CHANNELS, true);
     addBooleanParameter(Parameter::GLOBAL_SCOPE, "StimOn", "Determines whether events should be generated", true);
 
+    // OSC output of TTL events arriving from upstream (port 0 disables it)
+    addStringParameter(Parameter::GLOBAL_SCOPE, "OutHost", "Destination host for OSC output", "127.0.0.1");
+    addIntParameter(Parameter::GLOBAL_SCOPE, "OutPort", "Destination port for OSC output (0: disabled)", 0, 0, 65535);
+    addStringParameter(Parameter::GLOBAL_SCOPE, "OutAddress", "OSC address of output messages", DEFAULT_OUTPUT_ADDRESS);
+
+    // continuous channels streamed to the same destination, decimated
+    addStringParameter(Parameter::GLOBAL_SCOPE, "StreamChannels",
+                       "Continuous channels streamed to the OSC output, e.g. '1,2,5' (empty: none)", "", true);
+    addIntParameter(Parameter::GLOBAL_SCOPE, "StreamRate", "Most OSC data packets sent per second, per stream",
+                    30, 1, 1000, true);
+    addIntParameter(Parameter::GLOBAL_SCOPE, "StreamSamples", "Values per channel in each OSC data packet",
+                    10, 1, 1000, true);
+    addCategoricalParameter(Parameter::GLOBAL_SCOPE, "StreamFormat", "OSC data packets carry float arguments or one blob",
+                            { "floats", "blob" }, 0, true);
+
+    // text event metadata: the numeric arguments of the message
+    m_textMetadata.add(new MetadataValue(MetadataDescriptor::INT32, 1));
+    m_textMetadata.add(new MetadataValue(MetadataDescriptor::DOUBLE, TEXT_EVENT_MAX_VALUES));
+
+    m_labelTexts.resize(LABEL_TABLE_CAPACITY);
+
+#if OSC_TRACE_ENABLED
+    m_trace.startThread();
+#endif
 }
 
 AudioProcessorEditor *OSCEventsNode::createEditor()
@@ -49,19 +113,31 @@ int OSCEventsNode::getPort() const
         return DEFAULT_PORT;
 }
 
-void OSCEventsNode::setPort(int port)
+bool OSCEventsNode::createModule(int port, String address, String routes)
 {
-    String oscAddress = getOscAddress();
+    oscModule.reset(nullptr);
 
-    if(getPort() != port)
+    oscModule = std::make_unique<OSCModule>(port, address, routes, m_numListenerThreads, m_listenerCores, this);
+
+    if(!oscModule->isBound())
     {
         oscModule.reset(nullptr);
-        
-        oscModule = std::make_unique<OSCModule>(port, oscAddress, this);
+        return false;
+    }
+
+    return true;
+}
+
+void OSCEventsNode::setPort(int port)
+{
+    if(getPort() != port)
+    {
+        // a running listener is moved without losing queued messages
+        bool bound = oscModule ? oscModule->setPort(port)
+                               : createModule(port, getOscAddress(), getRoutes());
 
-        if(!oscModule->m_server->isBound())
+        if(!bound)
         {
-            oscModule.reset(nullptr);
             AlertWindow::showMessageBoxAsync(AlertWindow::AlertIconType::WarningIcon,
                                              "OSC Events [" + (String)getNodeId() + "]",
                                              "Unable to bind to port: " + (String)port
@@ -72,21 +148,12 @@ void OSCEventsNode::setPort(int port)
 
 void OSCEventsNode::setOscAddress (String address)
 {
-    int port = getPort();
-    
     if(!getOscAddress().equalsIgnoreCase(address))
     {
-        oscModule.reset(nullptr);
-        
-        oscModule = std::make_unique<OSCModule>(port, address, this);
-        if(!oscModule->m_server->isBound())
-        {
-            oscModule.reset(nullptr);
-            AlertWindow::showMessageBoxAsync(AlertWindow::AlertIconType::WarningIcon,
-                                             "OSC Events [" + (String)getNodeId() + "]",
-                                             "Unable to bind to port: " + (String)port
-                                             + "\nPlease try a different one!");
-        }
+        if(oscModule)
+            oscModule->setRoutes(address, getRoutes());
+        else
+            createModule(getPort(), address, getRoutes());
     }
 }
 
@@ -98,6 +165,42 @@ String OSCEventsNode::getOscAddress() const
         return DEFAULT_OSC_ADDRESS;
 }
 
+void OSCEventsNode::setRoutes(String routes)
+{
+    if(getRoutes() != routes)
+    {
+        if(oscModule)
+            oscModule->setRoutes(getOscAddress(), routes);
+        else
+            createModule(getPort(), getOscAddress(), routes);
+    }
+}
+
+String OSCEventsNode::getRoutes() const
+{
+    if(oscModule)
+        return oscModule->m_routes;
+    else
+        return String();
+}
+
+void OSCEventsNode::setListenerThreads(int numThreads, String cores)
+{
+    if(numThreads == m_numListenerThreads && cores == m_listenerCores)
+        return;
+
+    m_numListenerThreads = numThreads;
+    m_listenerCores = cores;
+
+    // the servers are recreated with the new sharding
+    if(oscModule && !createModule(getPort(), getOscAddress(), getRoutes()))
+    {
+        AlertWindow::showMessageBoxAsync(AlertWindow::AlertIconType::WarningIcon,
+                                         "OSC Events [" + (String)getNodeId() + "]",
+                                         "Unable to restart the listener on port: " + (String)getPort());
+    }
+}
+
 void OSCEventsNode::startStimulation()
 {
     m_isOn = true;
@@ -133,6 +236,26 @@ void OSCEventsNode::parameterValueChanged(Parameter *param)
         String address = param->getValueAsString();
         setOscAddress( address);
     }
+    else if(param->getName().equalsIgnoreCase("Routes"))
+    {
+        String routes = param->getValueAsString();
+        setRoutes(routes);
+    }
+    else if(param->getName().equalsIgnoreCase("Threads"))
+    {
+        int numThreads = static_cast<IntParameter*>(param)->getIntValue();
+        setListenerThreads(numThreads, m_listenerCores);
+    }
+    else if(param->getName().equalsIgnoreCase("Cores"))
+    {
+        String cores = param->getValueAsString();
+        setListenerThreads(m_numListenerThreads, cores);
+    }
+    else if(param->getName().equalsIgnoreCase("Values"))
+    {
+        // the channels are added in updateSettings()
+        CoreServices::updateSignalChain(getEditor());
+    }
     else if (param->getName().equalsIgnoreCase("Duration"))
     {
         int duration = static_cast<IntParameter*>(param)->getIntValue();
@@ -157,6 +280,10 @@ void OSCEventsNode::updateSettings()
 
     settings.update(getDataStreams());
 
+    m_streams.clear();
+
+    int numValueChannels = static_cast<IntParameter*>(getParameter("Values"))->getIntValue();
+
     for (auto stream : getDataStreams())
     {        
         EventChannel* ttlChan;
@@ -173,6 +300,56 @@ void OSCEventsNode::updateSettings()
         eventChannels.add(ttlChan);
         eventChannels.getLast()->addProcessor(processorInfo.get());
         settings[stream->getStreamId()]->eventChannelPtr = eventChannels.getLast();
+
+        OSCEventsNodeSettings* streamSettings = settings[stream->getStreamId()];
+
+        EventChannel::Settings textChanSettings{
+            EventChannel::Type::TEXT,
+            "OSC Events text output",
+            "Text of OSC messages on mode=text routes, with their numeric arguments as metadata",
+            "osc.events.text",
+            getDataStream(stream->getStreamId())
+        };
+
+        EventChannel* textChan = new EventChannel(textChanSettings);
+
+        textChan->addEventMetadata(MetadataDescriptor(MetadataDescriptor::INT32, 1, "Value count",
+                                                      "Number of numeric arguments of the message",
+                                                      "osc.text.numvalues"));
+        textChan->addEventMetadata(MetadataDescriptor(MetadataDescriptor::DOUBLE, TEXT_EVENT_MAX_VALUES, "Values",
+                                                      "Numeric arguments of the message, in order, unused entries 0",
+                                                      "osc.text.values"));
+
+        eventChannels.add(textChan);
+        eventChannels.getLast()->addProcessor(processorInfo.get());
+        streamSettings->textChannelPtr = eventChannels.getLast();
+
+        streamSettings->valueChannels.clear();
+
+        for (int i = 0; i < numValueChannels; i++)
+        {
+            ContinuousChannel::Settings valueChanSettings{
+                ContinuousChannel::Type::AUX,
+                "OSC" + String(i + 1),
+                "Values of OSC messages on mode=value routes",
+                "osc.values",
+                1.0f,
+                getDataStream(stream->getStreamId())
+            };
+
+            continuousChannels.add(new ContinuousChannel(valueChanSettings));
+            continuousChannels.getLast()->addProcessor(processorInfo.get());
+            streamSettings->valueChannels.add(continuousChannels.getLast());
+        }
+
+        // storage for the pending values is reserved here, not on the audio thread
+        streamSettings->values.setNumChannels(numValueChannels,
+                                              (int64) (stream->getSampleRate() * MAX_VALUE_RAMP_MS / 1000));
+        streamSettings->valueBuffers.assign(numValueChannels, nullptr);
+
+        streamSettings->streamId = stream->getStreamId();
+        streamSettings->sampleRate = stream->getSampleRate();
+        m_streams.push_back(streamSettings);
     }
 
     parameterValueChanged(getParameter("Duration"));
@@ -180,15 +357,16 @@ void OSCEventsNode::updateSettings()
 
     int port = static_cast<IntParameter*>(getParameter("Port"))->getIntValue();
     String address = getParameter("Address")->getValueAsString();
+    String routes = getParameter("Routes")->getValueAsString();
+
+    m_numListenerThreads = static_cast<IntParameter*>(getParameter("Threads"))->getIntValue();
+    m_listenerCores = getParameter("Cores")->getValueAsString();
     
     while(oscModule == nullptr)
     {
-        oscModule = std::make_unique<OSCModule>(port, address, this);
-
-        if(!oscModule->m_server->isBound())
+        if(!createModule(port, address, routes))
         {
             LOGC("Tyring new port:", port + 1);
-            oscModule.reset(nullptr);
             port++;
         }
     }
@@ -197,178 +375,518 @@ void OSCEventsNode::updateSettings()
     getEditor()->updateView();
 }
 
-void OSCEventsNode::triggerEvent(int ttlLine, bool state)
-{   
+int64 OSCEventsNode::getEventSampleNumber(uint64 timeNs, int64 startSampleNum, float sampleRate, int nSamples) const
+{
+    // unknown time: fall back to the start of the block
+    if (timeNs == 0 || nSamples <= 0)
+        return startSampleNum;
 
-    int streamIndex = 0;
-    
-    for (auto stream : getDataStreams())
-    {     
-        int64 startSampleNum = getFirstSampleNumberForBlock(stream->getStreamId());
-        int nSamples = getNumSamplesInBlock(stream->getStreamId());
+    // the last sample of the block was acquired (approximately) when process() was called
+    int64 lastSampleNum = startSampleNum + nSamples - 1;
 
-        if (m_pulseDurationMs > 0)
-            state = true; // all events are "ON" events if pulse duration is set
+    if (timeNs >= m_blockAnchorNs)
+    {
+        double aheadSeconds = (timeNs - m_blockAnchorNs) * 1e-9;
 
-        // Create and Send ON event
-        TTLEventPtr event = TTLEvent::createTTLEvent(eventChannels[streamIndex],
-                                                     startSampleNum,
-                                                     ttlLine,
-                                                     state);
+        // time tags from a badly synchronised sender should not hold events back indefinitely
+        if (aheadSeconds * 1000.0 > MAX_SCHEDULE_AHEAD_MS)
+            return lastSampleNum;
 
-        LOGD("Adding on event at ", startSampleNum);
-        
-        addEvent(event, 0);
+        return lastSampleNum + (int64) (aheadSeconds * sampleRate);
+    }
 
-        if (m_pulseDurationMs > 0)
-        {
-            // Create OFF event
-            int eventDurationSamp = static_cast<int>(ceil(m_pulseDurationMs / 1000.0f * stream->getSampleRate()));
-
-            TTLEventPtr eventOff = TTLEvent::createTTLEvent(settings[stream->getStreamId()]->eventChannelPtr,
-                startSampleNum + eventDurationSamp,
-                ttlLine,
-                false);
-
-            // Add or schedule turning-off event
-            // We don't care whether there are other turning-offs scheduled to occur either in
-            // this buffer or later. The abilities to change event duration during acquisition and for
-            // events to be longer than the timeout period create a lot of possibilities and edge cases,
-            // but overwriting turnoffEvent unconditionally guarantees that this and all previously
-            // turned-on events will be turned off by this "turning-off" if they're not already off.
-            if (eventDurationSamp < nSamples)
-            {
-                addEvent(eventOff, eventDurationSamp);
-            }
-                
-            else
-            {
-                LOGD("Adding off event at ", eventOff->getSampleNumber());
-                settings[stream->getStreamId()]->turnoffEvent = eventOff;
-            }
-                
-        }
+    double ageSeconds = (m_blockAnchorNs - timeNs) * 1e-9;
+    int64 samplesAgo = (int64) (ageSeconds * sampleRate);
+
+    // messages older than this block are placed at its first sample
+    return jmax(startSampleNum, lastSampleNum - samplesAgo);
+}
+
+void OSCEventsNode::triggerEvent(const MessageData& message)
+{   
+    int durationMs = message.durationMs < 0 ? m_pulseDurationMs : message.durationMs;
+
+    // messages that fire on arrival have their events emitted in this block
+    if (message.arrivalTimeNs != 0 && message.arrivalTimeNs <= m_blockAnchorNs
+        && message.timeTagNs <= m_blockAnchorNs)
+        m_stats.arrivalToEmitNs.record(m_blockAnchorNs - message.arrivalTimeNs);
 
-        streamIndex++;
+    if (message.streamIndex >= 0)
+    {
+        if (message.streamIndex < (int) m_streams.size())
+            scheduleMessage(*m_streams[message.streamIndex], message, durationMs);
+
+        return;
     }
+
+    for (auto stream : m_streams)
+        scheduleMessage(*stream, message, durationMs);
 }
 
-void OSCEventsNode::process(AudioBuffer<float>& buffer)
+void OSCEventsNode::scheduleMessage(OSCEventsNodeSettings& stream, const MessageData& message, int durationMs)
 {
+    if (message.valueChannel >= 0)
+    {
+        scheduleValues(stream, message);
+        return;
+    }
 
-    if (!m_isOn || !oscModule)
+    if (message.isText)
+    {
+        scheduleText(stream, message);
         return;
+    }
 
-    // turn off event from previous buffer if necessary
-    for (auto stream : getDataStreams())
+    int ttlLine = message.ttlLine;
+
+    // bundled messages fire at their time tag, everything else at its arrival time
+    int64 eventSampleNum = getEventSampleNumber(message.timeTagNs != 0 ? message.timeTagNs : message.arrivalTimeNs,
+                                                stream.startSampleNum, stream.sampleRate, stream.nSamples);
+
+    if (durationMs > 0)
     {
+        // all events are "ON" events if pulse duration is set
+        int eventDurationSamp = static_cast<int>(ceil(durationMs / 1000.0f * stream.sampleRate));
 
-        auto settingsModule = settings[stream->getStreamId()];
+        OSC_TRACE(m_trace, AUDIO, TRACE_PULSE_SCHEDULED, ttlLine, eventDurationSamp, eventSampleNum);
 
-        if (!settingsModule->turnoffEvent)
+        // overlapping pulses on the same line keep it on until the last one ends
+        if (!stream.scheduler.schedulePulse(eventSampleNum, eventSampleNum + eventDurationSamp, ttlLine))
+            increment(m_stats.schedulerDrops);
+    }
+    else
+    {
+        OSC_TRACE(m_trace, AUDIO, TRACE_EDGE_SCHEDULED, ttlLine, message.state, eventSampleNum);
+
+        if (!stream.scheduler.schedule(eventSampleNum, ttlLine, message.state))
+            increment(m_stats.schedulerDrops);
+    }
+}
+
+void OSCEventsNode::scheduleValues(OSCEventsNodeSettings& stream, const MessageData& message)
+{
+    int64 sampleNum = getEventSampleNumber(message.timeTagNs != 0 ? message.timeTagNs : message.arrivalTimeNs,
+                                           stream.startSampleNum, stream.sampleRate, stream.nSamples);
+
+    int channel = message.valueChannel;
+
+    // the arguments are read from the message's packet slab, in place.
+    // arguments that are not numbers leave their channel unchanged
+    for (auto argument = message.message.ArgumentsBegin();
+         argument != message.message.ArgumentsEnd() && channel < stream.values.getNumChannels();
+         ++argument, ++channel)
+    {
+        if (!isNumber(*argument))
             continue;
-        
-        int startSampleNum = getFirstSampleNumberForBlock(stream->getStreamId());
-        int nSamples = getNumSamplesInBlock(stream->getStreamId());
-        int turnoffOffset = jmax(0, (int)(settingsModule->turnoffEvent->getSampleNumber() - startSampleNum));
 
-        if (turnoffOffset < nSamples)
-        {
-            addEvent(settingsModule->turnoffEvent, turnoffOffset);
-            settingsModule->turnoffEvent = nullptr;
-        }
+        float value = (float) toDouble(*argument);
+
+        OSC_TRACE(m_trace, AUDIO, TRACE_VALUE_SCHEDULED, channel, (int64) (value * 1000.0f), sampleNum);
 
+        if (!stream.values.schedule(sampleNum, channel, value, message.interpolate))
+            increment(m_stats.schedulerDrops);
     }
+}
+
+void OSCEventsNode::scheduleText(OSCEventsNodeSettings& stream, const MessageData& message)
+{
+    int64 sampleNum = getEventSampleNumber(message.timeTagNs != 0 ? message.timeTagNs : message.arrivalTimeNs,
+                                           stream.startSampleNum, stream.sampleRate, stream.nSamples);
+
+    // every text event of the message carries all of its numeric arguments
+    double values[TEXT_EVENT_MAX_VALUES];
+    int numValues = 0;
 
-    lock.enter();
+    for (auto argument = message.message.ArgumentsBegin(); argument != message.message.ArgumentsEnd(); ++argument)
+    {
+        if (isNumber(*argument) && numValues < TEXT_EVENT_MAX_VALUES)
+            values[numValues++] = toDouble(*argument);
+    }
 
-    for (int i = 0; i < oscModule->m_messageQueue->count(); i++)
+    for (auto argument = message.message.ArgumentsBegin(); argument != message.message.ArgumentsEnd(); ++argument)
     {
-        MessageData msg = oscModule->m_messageQueue->pop();
+        if (!isText(*argument))
+            continue;
+
+        int label = internLabel(argument->IsString() ? argument->AsStringUnchecked() : argument->AsSymbolUnchecked());
 
-        LOGD("Triggering event for message");
-        
-        triggerEvent(msg.ttlLine, msg.state);
+        if (label < 0 || !stream.textScheduler.schedule(sampleNum, label, values, numValues))
+            increment(m_stats.schedulerDrops);
     }
+}
+
+int OSCEventsNode::internLabel(const char* text)
+{
+    bool added;
+    int label = m_labels.intern(text, added);
 
-    lock.exit();
-   
+    // the only allocation for a label, the first time it is seen
+    if (added)
+        m_labelTexts[label] = String::fromUTF8(text, m_labels.getLength(label));
+    else if (label < 0)
+        m_labelDrops++;
+
+    return label;
 }
 
-bool OSCEventsNode::startAcquisition()
+void OSCEventsNode::writeValueChannels(AudioBuffer<float>& buffer)
 {
-    if(oscModule)
+    for (auto stream : m_streams)
     {
-        LOGC("[OSC Events] Clearing message queue before starting acquisition")
+        if (stream->values.getNumChannels() == 0 || stream->nSamples <= 0)
+            continue;
 
-        lock.enter();
-        oscModule->m_messageQueue->clear();
-        lock.exit();
+        for (int i = 0; i < stream->valueChannels.size(); i++)
+            stream->valueBuffers[i] = buffer.getWritePointer(stream->valueChannels[i]->getGlobalIndex());
 
-        LOGD("Message QUEUE SIZE: ", oscModule->m_messageQueue->count());
+        // every sample of the block is written, between updates too
+        stream->values.write(stream->valueBuffers.data(), stream->startSampleNum, stream->nSamples);
     }
-
-    return true;
 }
 
-void OSCEventsNode::receiveMessage(const MessageData &message)
+void OSCEventsNode::setupStreaming(const String& host, int port)
 {
+    StringArray channelNumbers = StringArray::fromTokens(getParameter("StreamChannels")->getValueAsString(), ", ", "");
+    channelNumbers.removeEmptyStrings();
 
-    lock.enter();
+    const int rate = static_cast<IntParameter*>(getParameter("StreamRate"))->getIntValue();
+    const bool useBlobs = static_cast<CategoricalParameter*>(getParameter("StreamFormat"))->getSelectedIndex() == 1;
 
-    LOGD("Pushing message to queue");
+    int framesPerPacket = static_cast<IntParameter*>(getParameter("StreamSamples"))->getIntValue();
+    int maxValues = 0;
 
-    if(CoreServices::getAcquisitionStatus())
-        oscModule->m_messageQueue->push(message);
+    for (auto stream : m_streams)
+    {
+        stream->streamedChannels.clear();
+
+        // channel numbers count from 1, over all streams
+        for (const String& number : channelNumbers)
+        {
+            int channel = number.getIntValue() - 1;
+
+            if (channel >= 0 && channel < continuousChannels.size()
+                && continuousChannels[channel]->getStreamId() == stream->streamId)
+                stream->streamedChannels.push_back(channel);
+        }
+
+        stream->streamedBuffers.assign(stream->streamedChannels.size(), nullptr);
+
+        const int numChannels = (int) stream->streamedChannels.size();
+
+        if (numChannels == 0)
+        {
+            stream->decimator.setup(0, 1, 1);
+            continue;
+        }
 
-    LOGD("Message QUEUE SIZE: ", oscModule->m_messageQueue->count());
-   
-    lock.exit();
+        // packets stay below the UDP datagram limit
+        int frames = jmin(framesPerPacket, jmax(1, STREAM_MAX_VALUES / numChannels));
+
+        // rounded up, so the packet rate never exceeds StreamRate
+        int decimation = jmax(1, (int) std::ceil(stream->sampleRate / (rate * frames)));
+
+        stream->decimator.setup(numChannels, decimation, frames);
+        stream->streamSampleRate = stream->sampleRate / decimation;
+
+        maxValues = jmax(maxValues, numChannels * frames);
+    }
+
+    if (maxValues == 0)
+        return;
+
+    m_streamSender = std::make_unique<OSCStreamSender>(host, port, useBlobs, maxValues);
+
+    if (m_streamSender->isConnected())
+        m_streamSender->startThread();
+    else
+        m_streamSender.reset(nullptr);
 }
 
+void OSCEventsNode::streamChannels(AudioBuffer<float>& buffer)
+{
+    for (auto stream : m_streams)
+    {
+        if (stream->streamedChannels.empty() || stream->nSamples <= 0)
+            continue;
+
+        for (int i = 0; i < (int) stream->streamedChannels.size(); i++)
+            stream->streamedBuffers[i] = buffer.getReadPointer(stream->streamedChannels[i]);
 
-void MessageQueue::push(const MessageData &message)
+        // packets are packed into the sender's preallocated buffers right here;
+        // a packet is dropped (and counted) rather than waiting for a free buffer
+        stream->decimator.process(stream->streamedBuffers.data(), stream->nSamples, stream->startSampleNum,
+                                  [&](const float* frames, int64 firstSampleNum)
+        {
+            m_streamSender->sendFrames(stream->streamId, firstSampleNum, stream->streamSampleRate, frames,
+                                       stream->decimator.getFramesPerPacket(), stream->decimator.getNumChannels());
+        });
+    }
+}
+
+void OSCEventsNode::emitScheduledEvents()
 {
-    queue.add(message);
+    for (auto stream : m_streams)
+    {
+        const int64 blockEndSampleNum = stream->startSampleNum + stream->nSamples;
+
+        TTLEdge edge;
+
+        while (stream->scheduler.popEdgeBefore(blockEndSampleNum, edge))
+        {
+            // edges that were due while no block was processed go at the start of this one
+            int64 sampleNumber = jmax(edge.sampleNumber, stream->startSampleNum);
+
+            // the event is serialised by addEvent(), so it only lives for this call
+            TTLEventPtr event = TTLEvent::createTTLEvent(stream->eventChannelPtr,
+                                                         sampleNumber,
+                                                         edge.line,
+                                                         edge.state);
+
+            addEvent(event, (int) (sampleNumber - stream->startSampleNum));
+            increment(m_stats.eventsEmitted);
+
+            OSC_TRACE(m_trace, AUDIO, TRACE_EVENT_EMITTED, edge.line, edge.state, sampleNumber);
+        }
+
+        PendingTextEvent textEvent;
+
+        while (stream->textScheduler.popEventBefore(blockEndSampleNum, textEvent))
+        {
+            int64 sampleNumber = jmax(textEvent.sampleNumber, stream->startSampleNum);
+
+            m_textMetadata[0]->setValue((int32) textEvent.numValues);
+            m_textMetadata[1]->setValue(textEvent.values);
+
+            // the label's String is shared with the table, not copied
+            TextEventPtr event = TextEvent::createTextEvent(stream->textChannelPtr,
+                                                            sampleNumber,
+                                                            m_labelTexts[textEvent.label],
+                                                            m_textMetadata);
+
+            addEvent(event, (int) (sampleNumber - stream->startSampleNum));
+            increment(m_stats.eventsEmitted);
+
+            OSC_TRACE(m_trace, AUDIO, TRACE_TEXT_EMITTED, textEvent.label, textEvent.numValues, sampleNumber,
+                      m_labels.getText(textEvent.label));
+        }
+    }
 }
 
-MessageData MessageQueue::pop()
+void OSCEventsNode::process(AudioBuffer<float>& buffer)
 {
-    return queue.removeAndReturn(0);
+
+    // forwards upstream TTL events to the OSC sender through handleTTLEvent()
+    if (m_sender)
+        checkForEvents();
+
+    // block bounds are looked up once per stream, not once per message
+    for (auto stream : m_streams)
+    {
+        stream->startSampleNum = getFirstSampleNumberForBlock(stream->streamId);
+        stream->nSamples = getNumSamplesInBlock(stream->streamId);
+    }
+
+    if (oscModule && m_isOn)
+    {
+        // wall-clock anchor used to place messages at their arrival sample
+        m_blockAnchorNs = GetPacketClockNanoseconds();
+
+        MessageData msg;
+
+        // with several listener threads, the queues are merged in arrival order
+        while (oscModule->popMessage(msg))
+        {
+            increment(m_stats.messagesProcessed);
+            triggerEvent(msg);
+
+            // the message's view of its packet slab is not used past this point
+            msg.releaseSlab();
+        }
+    }
+
+    // pulses that are already running still get turned off when stimulation is disabled
+    emitScheduledEvents();
+
+    // value channels hold their last value when stimulation is disabled
+    writeValueChannels(buffer);
+
+    // after the value channels, so they can be streamed too
+    if (m_streamSender)
+        streamChannels(buffer);
 }
 
-bool MessageQueue::isEmpty()
+bool OSCEventsNode::startAcquisition()
 {
-    return queue.size() == 0;
+    if(oscModule)
+    {
+        LOGC("[OSC Events] Clearing message queues before starting acquisition")
+
+        // process() is not running yet, so this thread can act as the queues' consumer
+        for (auto& queue : oscModule->m_messageQueues)
+        {
+            MessageData msg;
+
+            while (queue->pop(msg))
+                msg.releaseSlab();
+
+            queue->resetDroppedCount();
+        }
+    }
+
+    m_stats.reset();
+
+    for (auto stream : m_streams)
+    {
+        stream->scheduler.clear();
+        stream->values.clear();
+        stream->textScheduler.clear();
+    }
+
+    // no text events are pending, so the labels can start over
+    m_labels.clear();
+    m_labelDrops = 0;
+
+    int outputPort = static_cast<IntParameter*>(getParameter("OutPort"))->getIntValue();
+
+    if (outputPort > 0)
+    {
+        m_sender = std::make_unique<OSCSender>(getParameter("OutHost")->getValueAsString(),
+                                               outputPort,
+                                               getParameter("OutAddress")->getValueAsString());
+
+        if (m_sender->isConnected())
+            m_sender->startThread();
+        else
+            m_sender.reset(nullptr);
+
+        setupStreaming(getParameter("OutHost")->getValueAsString(), outputPort);
+    }
+
+    return true;
 }
 
-void MessageQueue::clear()
+bool OSCEventsNode::stopAcquisition()
 {
-    queue.clear();
+    if (m_sender)
+    {
+        if (m_sender->getDroppedCount() > 0)
+            LOGC("[OSC Events] Dropped ", (int64) m_sender->getDroppedCount(),
+                 " output events because the queue was full");
+
+        // flushes the remaining events and stops the sender thread
+        m_sender.reset(nullptr);
+    }
+
+    if (m_streamSender)
+    {
+        if (m_streamSender->getDroppedCount() > 0)
+            LOGC("[OSC Events] Dropped ", (int64) m_streamSender->getDroppedCount(),
+                 " OSC data packets because the sender fell behind");
+
+        m_streamSender.reset(nullptr);
+    }
+
+    if(oscModule)
+    {
+        uint64 dropped = 0;
+
+        for (auto& queue : oscModule->m_messageQueues)
+            dropped += queue->getDroppedCount();
+
+        if (dropped > 0)
+            LOGC("[OSC Events] Dropped ", (int64) dropped, " messages because the queue was full");
+    }
+
+    for (auto stream : getDataStreams())
+    {
+        uint64 dropped = settings[stream->getStreamId()]->scheduler.getDroppedCount();
+
+        if (dropped > 0)
+            LOGC("[OSC Events] Dropped ", (int64) dropped, " TTL events on stream ",
+                 stream->getName(), " because too many were pending");
+
+        dropped = settings[stream->getStreamId()]->values.getDroppedCount();
+
+        if (dropped > 0)
+            LOGC("[OSC Events] Dropped ", (int64) dropped, " values on stream ",
+                 stream->getName(), " because too many were pending");
+
+        dropped = settings[stream->getStreamId()]->textScheduler.getDroppedCount();
+
+        if (dropped > 0)
+            LOGC("[OSC Events] Dropped ", (int64) dropped, " text events on stream ",
+                 stream->getName(), " because too many were pending");
+    }
+
+    if (m_labelDrops > 0)
+        LOGC("[OSC Events] Dropped ", (int64) m_labelDrops, " text events because more than ",
+             LABEL_TABLE_CAPACITY, " distinct labels were received");
+
+    return true;
 }
 
-int MessageQueue::count() 
+void OSCEventsNode::handleTTLEvent(TTLEventPtr event)
 {
-    return queue.size();
+    OutputEventData outputEvent;
+
+    outputEvent.sampleNumber = event->getSampleNumber();
+    outputEvent.streamId = event->getStreamId();
+    outputEvent.ttlLine = event->getLine();
+    outputEvent.state = event->getState();
+
+    // lock-free: never blocks the audio thread
+    m_sender->push(outputEvent);
+}
+
+void OSCEventsNode::receiveMessage(int shard, MessageData &message)
+{
+    // lock-free: drops (and counts) the message if the queue is full.
+    // every listener thread has a queue of its own
+    if(CoreServices::getAcquisitionStatus())
+    {
+        if(oscModule->m_messageQueues[shard]->push(message))
+        {
+            increment(m_stats.messagesQueued);
+            return;
+        }
+
+        increment(m_stats.queueDrops);
+        OSC_TRACE(m_trace, LISTENER + shard, TRACE_QUEUE_FULL, message.ttlLine);
+    }
+
+    // a message that was not queued gives its slab reference back
+    message.releaseSlab();
 }
 
 
 
 OSCServer::OSCServer(int port, 
     String address, 
-    OSCEventsNode *processor)
-    : Thread("OscListener Thread"),
+    String routes,
+    OSCEventsNode *processor,
+    int shard,
+    bool reusePort,
+    PacketSlabPool* slabPool)
+    : Thread("OscListener Thread " + String(shard)),
        m_incomingPort(port), 
        m_oscAddress(address),
+       m_shard(shard),
+       m_slabPool(slabPool),
        m_processor(processor)
 {
-    LOGC("Creating OSC server - Port:", port, " Address:", address);
+    LOGC("Creating OSC server - Port:", port, " Address:", address, " Listener:", shard);
+
+    setRoutes(address, routes);
 
     try
     {
         m_listeningSocket = std::make_unique<UdpListeningReceiveSocket>(
             IpEndpointName(IpEndpointName::ANY_ADDRESS, m_incomingPort),
-            this);
+            this, reusePort);
+
+        // drain bursts of datagrams with one syscall per wakeup
+        m_listeningSocket->SetReceiveBatchSize(RECEIVE_BATCH_SIZE);
+        m_listeningSocket->SetMaxDatagramSize(RECEIVE_BUFFER_SIZE);
 
         CoreServices::sendStatusMessage("OSC Server ready!");
         LOGC("OSC Server started!");
@@ -391,50 +909,219 @@ OSCServer::~OSCServer()
 }
 
 void OSCServer::ProcessMessage(const osc::ReceivedMessage& receivedMessage,
-    const IpEndpointName&)
+    const IpEndpointName& remoteEndpoint)
 {
 
-    LOGD("Message received on ", receivedMessage.AddressPattern());
+    OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_MESSAGE_RECEIVED,
+              receivedMessage.ArgumentCount(), 0, 0, receivedMessage.AddressPattern());
 
-    try
+    OSCStats& stats = m_processor->getStats();
+    increment(stats.messagesReceived);
+
+    if (std::strcmp(receivedMessage.AddressPattern(), STATS_QUERY_ADDRESS) == 0)
     {
+        sendStats(remoteEndpoint);
+        return;
+    }
 
-		if (String(receivedMessage.AddressPattern()).equalsIgnoreCase(m_oscAddress))
-		{
-            LOGD("Num arguments: ", receivedMessage.ArgumentCount());
+    // marks the dispatch for setRoutes(), which frees a replaced table only
+    // once the listener is out of it
+    m_dispatchEpoch.fetch_add(1);
 
-            osc::ReceivedMessageArgumentStream args = receivedMessage.ArgumentStream();
+    // allocation-free; incoming address patterns may contain OSC wildcards
+    int numRoutes = m_activeRoutes.load()->dispatch(receivedMessage.AddressPattern(), [&](const OSCRoute& route)
+    {
+        routeMessage(route, receivedMessage);
+    });
 
-            int ttlLine = -1;
-            int state = true;
+    if (numRoutes == 0)
+        increment(stats.unmatchedMessages);
 
-            if (receivedMessage.ArgumentCount() > 0)
-                args >> ttlLine;
+    m_dispatchEpoch.fetch_add(1, std::memory_order_release);
+}
 
-            if (receivedMessage.ArgumentCount() > 1)
-                args >> state;
+void OSCServer::ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint)
+{
+    receivePacket(data, size, remoteEndpoint, 0);
+}
 
-            LOGD("TTL Line: ", ttlLine);
-            LOGD("TTL State: ", state);
+void OSCServer::ProcessTimestampedPacket(const char* data, int size, const IpEndpointName& remoteEndpoint,
+                                         unsigned long long arrivalTimeNs)
+{
+    receivePacket(data, size, remoteEndpoint, arrivalTimeNs);
+}
 
-            if (ttlLine >= 0)
-            {
-                MessageData messageData;
+void OSCServer::receivePacket(const char* data, int size, const IpEndpointName& remoteEndpoint,
+                              unsigned long long arrivalTimeNs)
+{
+    increment(m_processor->getStats().packetsReceived);
 
-                messageData.ttlLine = ttlLine;
-                messageData.state = bool(state);
+    // the receive buffer is reused for the next datagram, so packets whose
+    // messages are handed to the audio thread are copied into a slab once and
+    // parsed there: the messages are views of the slab, not copies
+    int slab = -1;
 
-                m_processor->receiveMessage(messageData);
-            }
-		}
-        
+    if (m_slabPool != nullptr && m_keepMessages.load(std::memory_order_relaxed))
+    {
+        slab = m_slabPool->acquire(data, size);
+
+        if (slab >= 0)
+            data = m_slabPool->getData(slab);
+    }
+
+    m_currentSlab = slab;
+
+    osc::OscPacketListener::ProcessTimestampedPacket(data, size, remoteEndpoint, arrivalTimeNs);
+
+    // the queued messages hold their own references
+    if (slab >= 0)
+        m_slabPool->release(slab);
+
+    m_currentSlab = -1;
+}
+
+void OSCServer::ProcessMalformedPacket(const char* error, const IpEndpointName&)
+{
+    increment(m_processor->getStats().malformedPackets);
+
+    // malformed packets are rejected without exceptions, so noisy senders stay cheap
+    OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_MALFORMED_PACKET, 0, 0, 0, nullptr, error);
+}
+
+void OSCServer::ProcessTruncatedPacket(int bufferSize, const IpEndpointName&)
+{
+    increment(m_processor->getStats().truncatedPackets);
+
+    OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_TRUNCATED_PACKET, bufferSize);
+}
+
+void OSCServer::routeMessage(const OSCRoute& route, const osc::ReceivedMessage& receivedMessage)
+{
+    osc::int32 ttlLine = route.ttlLine;
+    osc::int32 state = true;
+    bool booleanState;
+
+    // the state may be sent as an int32 or as an OSC boolean (T/F), and
+    // routes without a fixed line take the line from the first argument.
+    // trailing arguments (e.g. sequence numbers) are ignored
+    bool decoded;
+
+    if (route.mode == OSCRoute::VALUE)
+    {
+        // the values are read on the audio thread, from the message itself;
+        // messages that do not start with a number are not queued
+        decoded = receivedMessage.ArgumentCount() > 0 && isNumber(*receivedMessage.ArgumentsBegin());
     }
-    catch (osc::Exception &e)
+    else if (route.mode == OSCRoute::TEXT)
     {
-        // any parsing errors such as unexpected argument types, or
-        // missing arguments get thrown as exceptions.
-        LOGE("error while parsing message: ", String(receivedMessage.AddressPattern()), ": ", String(e.what()));
+        // likewise for the strings of text routes
+        decoded = hasText(receivedMessage);
     }
+    else if (route.ttlLine < 0)
+    {
+        decoded = osc::DecodeLeadingArguments(receivedMessage, ttlLine, state)
+               || osc::DecodeArguments(receivedMessage, ttlLine);
+
+        if (!decoded && osc::DecodeLeadingArguments(receivedMessage, ttlLine, booleanState))
+        {
+            state = booleanState;
+            decoded = true;
+        }
+    }
+    else
+    {
+        decoded = osc::DecodeLeadingArguments(receivedMessage, state)
+               || osc::DecodeArguments(receivedMessage);
+
+        if (!decoded && osc::DecodeLeadingArguments(receivedMessage, booleanState))
+        {
+            state = booleanState;
+            decoded = true;
+        }
+    }
+
+    if (!decoded)
+    {
+        OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_MESSAGE_IGNORED,
+                  receivedMessage.ArgumentCount(), 0, 0, receivedMessage.AddressPattern());
+        return;
+    }
+
+    if (route.mode == OSCRoute::VALUE)
+    {
+        OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_VALUES_ROUTED,
+                  route.valueChannel, 0, 0, receivedMessage.AddressPattern());
+    }
+    else if (route.mode == OSCRoute::TEXT)
+    {
+        OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_TEXT_ROUTED,
+                  0, 0, 0, receivedMessage.AddressPattern());
+    }
+    else
+    {
+        OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_MESSAGE_ROUTED,
+                  ttlLine, state, 0, receivedMessage.AddressPattern());
+
+        if (ttlLine < 0)
+            return;
+    }
+
+    MessageData messageData;
+
+    if (route.keepMessage)
+    {
+        // packet too large for a slab, or every slab in use
+        if (m_currentSlab < 0)
+        {
+            increment(m_processor->getStats().payloadDrops);
+            OSC_TRACE(m_processor->getTrace(), LISTENER + m_shard, TRACE_PAYLOAD_DROPPED,
+                      0, 0, 0, receivedMessage.AddressPattern());
+            return;
+        }
+
+        messageData.message = receivedMessage;
+        messageData.slabPool = m_slabPool;
+        messageData.slab = m_currentSlab;
+        m_slabPool->addReference(m_currentSlab);
+    }
+
+    messageData.ttlLine = ttlLine;
+    messageData.streamIndex = route.streamIndex;
+    messageData.arrivalTimeNs = PacketArrivalTime();
+    messageData.timeTagNs = BundleTime();
+
+    switch (route.mode)
+    {
+    case OSCRoute::PULSE:
+        messageData.state = bool(state);
+        messageData.durationMs = route.durationMs;
+        break;
+    case OSCRoute::STATE:
+        messageData.state = bool(state);
+        messageData.durationMs = 0;
+        break;
+    case OSCRoute::ON:
+        messageData.state = true;
+        messageData.durationMs = 0;
+        break;
+    case OSCRoute::OFF:
+        messageData.state = false;
+        messageData.durationMs = 0;
+        break;
+    case OSCRoute::VALUE:
+        messageData.state = false;
+        messageData.durationMs = 0;
+        messageData.valueChannel = route.valueChannel;
+        messageData.interpolate = route.interpolate;
+        break;
+    case OSCRoute::TEXT:
+        messageData.state = false;
+        messageData.durationMs = 0;
+        messageData.isText = true;
+        break;
+    }
+
+    m_processor->receiveMessage(m_shard, messageData);
 }
 
 void OSCServer::run()
@@ -446,6 +1133,73 @@ void OSCServer::run()
             m_listeningSocket->Run();
 }
 
+void OSCServer::setRoutes(String address, String routes)
+{
+    m_oscAddress = address;
+
+    auto routeTable = std::make_unique<OSCRouteTable>();
+
+    // the Address parameter is the default route: line and state taken from the arguments
+    OSCRoute defaultRoute;
+    defaultRoute.address = address.toStdString();
+    routeTable->addRoute(defaultRoute);
+
+    std::string errors = routeTable->addRoutes(routes.toStdString());
+
+    if (!errors.empty())
+        LOGC("Ignoring invalid OSC routes: ", String(errors));
+
+    routeTable->compile();
+
+    m_keepMessages.store(routeTable->keepsMessages());
+    m_activeRoutes.store(routeTable.get());
+    std::swap(m_routeTable, routeTable);
+
+    // grace period: if the listener was dispatching when the new table was
+    // published, it may still hold the old one until that dispatch ends
+    uint32 epoch = m_dispatchEpoch.load();
+
+    while ((epoch & 1) && m_dispatchEpoch.load(std::memory_order_acquire) == epoch)
+        Thread::yield();
+
+    // the old table is freed here
+}
+
+void OSCServer::sendStats(const IpEndpointName& remoteEndpoint)
+{
+    const OSCStats& stats = m_processor->getStats();
+    const LatencyHistogram& latency = stats.arrivalToEmitNs;
+
+    // counters first, then arrival -> emit latency percentiles in nanoseconds;
+    // values added later are appended, so existing argument positions stay put
+    char buffer[512];
+    osc::OutboundPacketStream packet(buffer, sizeof(buffer));
+
+    packet << osc::BeginMessage(STATS_QUERY_ADDRESS)
+           << (osc::int64) stats.packetsReceived.load()
+           << (osc::int64) stats.malformedPackets.load()
+           << (osc::int64) stats.messagesReceived.load()
+           << (osc::int64) stats.unmatchedMessages.load()
+           << (osc::int64) stats.messagesQueued.load()
+           << (osc::int64) stats.queueDrops.load()
+           << (osc::int64) stats.getQueueDepth()
+           << (osc::int64) stats.messagesProcessed.load()
+           << (osc::int64) stats.eventsEmitted.load()
+           << (osc::int64) stats.schedulerDrops.load()
+           << (osc::int64) latency.getCount()
+           << (osc::int64) latency.getValueAtPercentile(0.5)
+           << (osc::int64) latency.getValueAtPercentile(0.9)
+           << (osc::int64) latency.getValueAtPercentile(0.99)
+           << (osc::int64) latency.getValueAtPercentile(0.999)
+           << (osc::int64) latency.getMax()
+           << (osc::int64) stats.truncatedPackets.load()
+           << (osc::int64) stats.payloadDrops.load()
+           << osc::EndMessage;
+
+    // replies from the listening socket, so the sender gets it on its own port
+    m_listeningSocket->SendTo(remoteEndpoint, packet.Data(), packet.Size());
+}
+
 bool OSCServer::isBound()
 {
     if(m_listeningSocket)
@@ -466,3 +1220,105 @@ void OSCServer::stop()
         m_listeningSocket->AsynchronousBreak();
 }
 
+
+
+OSCModule::OSCModule(int port, String address, String routes, int numThreads, String cores, OSCEventsNode* processor)
+    : m_port(port), m_address(address), m_routes(routes), m_cores(cores), m_processor(processor)
+{
+    // only Linux spreads the datagrams of one port across several sockets
+    m_numThreads = UdpSocket::IsReusePortSupported() ? jlimit(1, MAX_LISTENER_THREADS, numThreads) : 1;
+
+    if (m_numThreads < numThreads)
+        LOGC("[OSC Events] SO_REUSEPORT is not supported, using a single listener thread");
+
+    for (int i = 0; i < m_numThreads; i++)
+    {
+        m_messageQueues.push_back(std::make_unique<MessageQueue>(MESSAGE_QUEUE_SIZE));
+        m_slabPools.push_back(std::make_unique<PacketSlabPool>(PACKET_SLAB_COUNT, PACKET_SLAB_SIZE));
+    }
+
+    if (createServers(port, m_servers))
+        startServers();
+}
+
+bool OSCModule::createServers(int port, std::vector<std::unique_ptr<OSCServer>>& servers) const
+{
+    const bool reusePort = m_numThreads > 1;
+
+    if (reusePort)
+    {
+        // SO_REUSEPORT would also let the servers share the port with another
+        // program (or another OSC Events node), so make sure it is free first
+        try
+        {
+            UdpReceiveSocket probe(IpEndpointName(IpEndpointName::ANY_ADDRESS, port));
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_numThreads; i++)
+    {
+        auto server = std::make_unique<OSCServer>(port, m_address, m_routes, m_processor, i, reusePort,
+                                                  m_slabPools[i].get());
+
+        if (!server->isBound())
+        {
+            servers.clear();
+            return false;
+        }
+
+        servers.push_back(std::move(server));
+    }
+
+    return true;
+}
+
+void OSCModule::startServers()
+{
+    StringArray cores = StringArray::fromTokens(m_cores, ", ", "");
+    cores.removeEmptyStrings();
+
+    for (int i = 0; i < (int) m_servers.size(); i++)
+    {
+        if (cores.size() > 0)
+        {
+            int core = cores[i % cores.size()].getIntValue();
+
+            if (core >= 0 && core < 32)
+                m_servers[i]->setAffinityMask(uint32(1) << core);
+        }
+
+        m_servers[i]->startThread();
+    }
+}
+
+bool OSCModule::setPort(int port)
+{
+    std::vector<std::unique_ptr<OSCServer>> servers;
+
+    if (!createServers(port, servers))
+        return false;
+
+    // datagrams sent to the new port are buffered by its sockets while the old
+    // servers' threads are joined; the threads feeding a queue never overlap,
+    // as each queue has a single producer
+    std::swap(m_servers, servers);
+    servers.clear();
+
+    startServers();
+    m_port = port;
+
+    return true;
+}
+
+void OSCModule::setRoutes(String address, String routes)
+{
+    for (auto& server : m_servers)
+        server->setRoutes(address, routes);
+
+    m_address = address;
+    m_routes = routes;
+}
@@ -26,53 +26,74 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <ProcessorHeaders.h>
 
 #include <stdio.h>
+#include <atomic>
 
 #define DEFAULT_PORT 27020
 #define DEFAULT_OSC_ADDRESS "/ttl"
+#define STATS_QUERY_ADDRESS "/oscevents/stats" // replies to the sender with the OSCStats counters
+#define MESSAGE_QUEUE_SIZE 4096
+#define RECEIVE_BATCH_SIZE 32
+#define RECEIVE_BUFFER_SIZE 65536 // largest UDP datagram, so big bundles are not truncated
+#define MAX_LISTENER_THREADS 8
+#define PACKET_SLAB_COUNT 1024 // per listener thread, for routes that keep their messages
+#define PACKET_SLAB_SIZE 2048  // larger packets cannot hand their messages to the audio thread
+#define MAX_SCHEDULE_AHEAD_MS 60000 // bundle time tags further ahead are treated as "immediately"
+#define MAX_VALUE_CHANNELS 16
+#define MAX_VALUE_RAMP_MS 1000 // longer gaps between interpolated updates jump instead
 
 #include "oscpack/osc/OscOutboundPacketStream.h"
 #include "oscpack/ip/IpEndpointName.h"
 #include "oscpack/osc/OscReceivedElements.h"
 #include "oscpack/osc/OscPacketListener.h"
+#include "oscpack/osc/OscTypedDecoder.h"
 #include "oscpack/ip/UdpSocket.h"
 
+#include "LockFreeQueue.h"
+#include "OSCRouteTable.h"
+#include "TTLEventScheduler.h"
+#include "OSCSender.h"
+#include "OSCStreamSender.h"
+#include "OSCStreamDecimator.h"
+#include "OSCStats.h"
+#include "OSCTrace.h"
+#include "PacketSlabPool.h"
+#include "OSCValueWriter.h"
+#include "OSCLabelTable.h"
+#include "TextEventScheduler.h"
+
 struct MessageData {
 	int ttlLine;
 	bool state;
-};
+	int streamIndex;      // -1 for all streams
+	int durationMs;       // -1 for the processor's pulse duration
+	uint64 arrivalTimeNs; // packet clock (see GetPacketClockNanoseconds), 0 if unknown
+	uint64 timeTagNs;     // bundle time tag on the packet clock, 0 for "immediately"
+	int valueChannel = -1; // value routes: channel of the first argument, -1 for TTL messages
+	bool interpolate = false;
+	bool isText = false;   // text routes
+
+	/** For routes that keep their messages (OSCRoute::keepMessage): the
+		message, a view of the packet slab it was received into. The slab
+		holds a reference for this message until process() releases it */
+	osc::ReceivedMessage message;
+	PacketSlabPool* slabPool = nullptr;
+	int slab = -1;
+
+	/** Drops the message's slab reference, if it holds one */
+	void releaseSlab()
+	{
+		if (slab >= 0)
+			slabPool->release(slab);
 
+		slab = -1;
+	}
+};
 
 /** 
-	Stores incoming messages in a queue
+	Stores incoming messages in a preallocated lock-free queue.
+	The OSC server thread is the only producer and process() the only consumer.
 */
-class MessageQueue
-{
-public:
-
-	/** Constructor */
-	MessageQueue() { }
-
-	/** Destructor */
-	~MessageQueue() { }
-
-	/** Adds a message to the queue */
-	void push(const MessageData &message);
-
-	/** Removes a message from the queue*/
-	MessageData pop();
-
-	/** True if the queue is empty*/
-	bool isEmpty();
-
-	/** Clears the queue*/
-	void clear();
-
-	/** Returns the number of messages available*/
-	int count();
-
-private:
-	Array<MessageData> queue;
-};
+typedef LockFreeQueue<MessageData> MessageQueue;
 
 class OSCEventsNode;
 
@@ -86,8 +107,11 @@ class OSCServer : public osc::OscPacketListener,
 {
 public:
 
-	/** Constructor */
-	OSCServer(int port, String address, OSCEventsNode* processor);
+	/** Constructor -- shard is the index of this server among those sharing
+		the port (with reusePort), and of the message queue it feeds. Packets
+		for routes that keep their messages are received into slabPool */
+	OSCServer(int port, String address, String routes, OSCEventsNode* processor,
+			  int shard = 0, bool reusePort = false, PacketSlabPool* slabPool = nullptr);
 
 	/** Destructor*/
 	~OSCServer();
@@ -101,69 +125,169 @@ public:
 	/** Check if server was bound successfully*/
 	bool isBound();
 
+	/** Replaces the routes while the server is listening. The new table is
+		published with a pointer swap; the old one is freed once the listener
+		thread is no longer dispatching through it */
+	void setRoutes(String address, String routes);
+
 protected:
 	/** OscPacketListener method*/
 	virtual void ProcessMessage(const osc::ReceivedMessage &m, const IpEndpointName &);
 
+	/** OscPacketListener method, called for packets that are not well formed */
+	void ProcessMalformedPacket(const char* error, const IpEndpointName &) override;
+
+	/** PacketListener method, called for datagrams larger than the receive buffer */
+	void ProcessTruncatedPacket(int bufferSize, const IpEndpointName &) override;
+
+	/** OscPacketListener methods, count packets before dispatching them */
+	void ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint) override;
+	void ProcessTimestampedPacket(const char* data, int size, const IpEndpointName& remoteEndpoint,
+								  unsigned long long arrivalTimeNs) override;
+
 private:
 
 	/** Copy constructor */
 	OSCServer(OSCServer const &);
 
+	/** Queues the message a route produces for an incoming OSC message */
+	void routeMessage(const OSCRoute& route, const osc::ReceivedMessage& receivedMessage);
+
+	/** Replies to a stats query with the current counters */
+	void sendStats(const IpEndpointName& remoteEndpoint);
+
+	/** Dispatches a packet, from a slab if any route keeps its messages */
+	void receivePacket(const char* data, int size, const IpEndpointName& remoteEndpoint,
+					   unsigned long long arrivalTimeNs);
+
 	int m_incomingPort;
 	String m_oscAddress;
+	int m_shard;
+
+	/** Precompiled routes for the addresses this server responds to, owned
+		by the message thread and read by the listener through m_activeRoutes */
+	std::unique_ptr<OSCRouteTable> m_routeTable;
+	std::atomic<OSCRouteTable*> m_activeRoutes { nullptr };
+
+	/** Odd while the listener thread is dispatching a message */
+	std::atomic<uint32> m_dispatchEpoch { 0 };
+
+	/** Set with the routes: packets are received into slabs */
+	std::atomic<bool> m_keepMessages { false };
+	PacketSlabPool* m_slabPool;
+
+	/** Listener thread: slab of the packet being dispatched, -1 for none */
+	int m_currentSlab = -1;
 
 	std::unique_ptr<UdpListeningReceiveSocket> m_listeningSocket;
 	OSCEventsNode* m_processor;
 };
 
-/** 
-	
-	Contains a message queue and an OSC server
+/**
+
+	Contains the OSC servers listening on one port and their message queues.
+
+	With more than one listener thread, every server binds the port with
+	SO_REUSEPORT and the kernel spreads the senders across them (Linux
+	only). Each server feeds its own queue; process() merges the queues
+	by packet arrival time.
 
 */
 class OSCModule
 {
 public:
 	
-	/** Constructor */
-	OSCModule(int port, String address, OSCEventsNode* processor)
-		:m_port(port), m_address(address)
-	{
-		m_messageQueue = std::make_unique<MessageQueue>();
-		m_server = std::make_unique<OSCServer>(port, address, processor);
-		if(m_server->isBound())
-			m_server->startThread();
-	}
+	/** Constructor -- cores is a comma separated list of CPU cores the
+		listener threads are pinned to in turn, empty for no pinning */
+	OSCModule(int port, String address, String routes, int numThreads, String cores, OSCEventsNode* processor);
 
 	/** Destructor */
 	~OSCModule() {}
 
+	/** True if the servers are listening */
+	bool isBound() const { return !m_servers.empty(); }
+
+	/** Moves the servers to a new port. The new sockets are bound before the
+		old servers are retired, and the message queues are kept. Returns false
+		(and keeps listening on the old port) if the port could not be bound */
+	bool setPort(int port);
+
+	/** Swaps the address and routes on the running servers */
+	void setRoutes(String address, String routes);
+
+	/** Audio thread: pops the earliest arrival waiting in any of the queues */
+	bool popMessage(MessageData& message)
+	{
+		if (m_messageQueues.size() == 1)
+			return m_messageQueues[0]->pop(message);
+
+		return popEarliest(m_messageQueues.begin(), m_messageQueues.end(), message,
+						   [](const MessageData& m) { return m.arrivalTimeNs; });
+	}
+
 	friend std::ostream &operator<<(std::ostream &, const OSCModule&);
 
 	int m_port = DEFAULT_PORT;
 	String m_address = String(DEFAULT_OSC_ADDRESS);
+	String m_routes;
+	int m_numThreads = 1;
+	String m_cores;
+	OSCEventsNode* m_processor;
+
+	/** One queue and slab pool per server, kept when the servers are
+		replaced, as queued messages may still reference the slabs */
+	std::vector<std::unique_ptr<MessageQueue>> m_messageQueues;
+	std::vector<std::unique_ptr<PacketSlabPool>> m_slabPools;
+	std::vector<std::unique_ptr<OSCServer>> m_servers;
+
+private:
+
+	/** Creates one server per thread, returns false unless all of them could bind the port */
+	bool createServers(int port, std::vector<std::unique_ptr<OSCServer>>& servers) const;
 
-	std::unique_ptr<MessageQueue> m_messageQueue;
-	std::unique_ptr<OSCServer> m_server;
+	/** Starts the server threads, pinned to the configured cores */
+	void startServers();
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCModule);
 };
 
-/** Holds settings for one stream's event channel */
+/** Holds settings for one stream's event channels and value channels */
 class OSCEventsNodeSettings
 {
 public:
 	/** Constructor -- sets default values*/
 	OSCEventsNodeSettings() :
-		eventChannelPtr(nullptr), turnoffEvent(nullptr) { }
+		eventChannelPtr(nullptr) { }
 
 	/** Destructor*/
 	~OSCEventsNodeSettings() { }
 
 	/** Parameters */
 	EventChannel* eventChannelPtr;
-	TTLEventPtr turnoffEvent; // holds a turnoff event that must be added in a later buffer
+	TTLEventScheduler scheduler; // pending on/off edges, emitted in the block they fall into
+
+	/** Text events of text routes, with their pending events */
+	EventChannel* textChannelPtr = nullptr;
+	TextEventScheduler textScheduler;
+
+	/** Continuous channels added for value routes, and what is written into them */
+	Array<ContinuousChannel*> valueChannels;
+	OSCValueWriter values;
+	std::vector<float*> valueBuffers; // write pointers for the current block
+
+	/** Continuous channels streamed as OSC (global indices), set up at the start of acquisition */
+	std::vector<int> streamedChannels;
+	std::vector<const float*> streamedBuffers; // read pointers for the current block
+	OSCStreamDecimator decimator;
+	float streamSampleRate = 0.0f;            // after decimation
+
+	/** Cached in updateSettings(), so messages fan out without looking up the stream */
+	uint16 streamId = 0;
+	float sampleRate = 0.0f;
+
+	/** The current block, set once per process() call */
+	int64 startSampleNum = 0;
+	int nSamples = 0;
 };
 
 
@@ -196,8 +320,22 @@ public:
 
 	bool startAcquisition() override;
 
-	// receives a message from the osc server
-	void receiveMessage(const MessageData &message);
+	bool stopAcquisition() override;
+
+	/** Forwards a TTL event from upstream to the OSC output */
+	void handleTTLEvent(TTLEventPtr event) override;
+
+	// receives a message from the osc server feeding queue shard; a message
+	// that is not queued has its slab reference released
+	void receiveMessage(int shard, MessageData &message);
+
+	/** Counters and latency histogram, updated by the listener and audio threads */
+	OSCStats& getStats() { return m_stats; }
+
+#if OSC_TRACE_ENABLED
+	/** Hot path trace records, written to the log by a background thread */
+	OSCTrace& getTrace() { return m_trace; }
+#endif
 
 	// Setter-Getters
 
@@ -207,6 +345,13 @@ public:
 	String getOscAddress() const;
 	void setOscAddress(String address);
 
+	String getRoutes() const;
+	void setRoutes(String routes);
+
+	/** Listener threads sharing the port, and the cores they are pinned to;
+		changing either restarts the listener */
+	void setListenerThreads(int numThreads, String cores);
+
 	int getTTLDuration() const;
 	void setTTLDuration(int duration_ms);
 
@@ -218,18 +363,83 @@ public:
 
 private:
 
-	CriticalSection lock;
-
 	// Stimulation parameters
 	bool m_isOn = true;
 	int m_pulseDurationMs = 50;
 
+	// declared before oscModule: the listener thread uses them until it is stopped
+	OSCStats m_stats;
+#if OSC_TRACE_ENABLED
+	OSCTrace m_trace { MAX_LISTENER_THREADS };
+#endif
+
+	int m_numListenerThreads = 1;
+	String m_listenerCores;
+
 	std::unique_ptr<OSCModule> oscModule;
 
+	/** Sends upstream TTL events as OSC messages, exists only during acquisition */
+	std::unique_ptr<OSCSender> m_sender;
+
+	/** Sends the streamed continuous channels, exists only during acquisition */
+	std::unique_ptr<OSCStreamSender> m_streamSender;
+
 	StreamSettings<OSCEventsNodeSettings> settings;
 
-	/** Triggers an event on the specified TTL line*/
-	void triggerEvent(int line, bool state);
+	/** Settings of every stream in stream order (message stream indices
+		index into it), rebuilt in updateSettings() */
+	std::vector<OSCEventsNodeSettings*> m_streams;
+
+	/** Audio thread: labels of text events, interned so repeated labels are
+		not copied again. m_labelTexts holds the String of each label id,
+		created when the label is first seen */
+	OSCLabelTable m_labels;
+	std::vector<String> m_labelTexts;
+	uint64 m_labelDrops = 0;
+
+	/** Audio thread: metadata of the text event being emitted, reused */
+	MetadataValueArray m_textMetadata;
+
+	/** Packet clock time at which the current block was handed to process() */
+	uint64 m_blockAnchorNs = 0;
+
+	/** Maps a packet clock time onto a sample number: past times fall inside
+		the current block (at its start if older), future times after it */
+	int64 getEventSampleNumber(uint64 timeNs, int64 startSampleNum, float sampleRate, int nSamples) const;
+
+	/** Replaces the OSC module, returns false if the port could not be bound */
+	bool createModule(int port, String address, String routes);
+
+	/** Schedules the events for a message on the specified TTL line*/
+	void triggerEvent(const MessageData& message);
+
+	/** Schedules the events for a message on one stream */
+	void scheduleMessage(OSCEventsNodeSettings& stream, const MessageData& message, int durationMs);
+
+	/** Adds every scheduled event that falls into the current block.
+		Scheduling allocates nothing, but each emitted event still costs the plugin
+		API's allocations: addEvent() copies every event into a temporary buffer,
+		so reusing event objects would not avoid them */
+	void emitScheduledEvents();
+
+	/** Schedules the text events of a text route's message on one stream */
+	void scheduleText(OSCEventsNodeSettings& stream, const MessageData& message);
+
+	/** Returns the id of a text event label, -1 if the label table is full */
+	int internLabel(const char* text);
+
+	/** Schedules the arguments of a value route's message on one stream */
+	void scheduleValues(OSCEventsNodeSettings& stream, const MessageData& message);
+
+	/** Writes the current block of every value channel */
+	void writeValueChannels(AudioBuffer<float>& buffer);
+
+	/** Sets up the decimators and the stream sender for the StreamChannels
+		parameter, called at the start of acquisition */
+	void setupStreaming(const String& host, int port);
+
+	/** Decimates the current block of the streamed channels, and hands completed packets to the stream sender */
+	void streamChannels(AudioBuffer<float>& buffer);
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCEventsNode);
 };
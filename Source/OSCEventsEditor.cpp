@@ -23,10 +23,56 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "OSCEventsEditor.h"
 #include "OSCEvents.h"
 
+OSCSettingsPanel::OSCSettingsPanel(GenericProcessor* processor)
+{
+    addSectionLabel("INPUT", 5);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("Routes")), 10, 25);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("Threads")), 110, 25);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("Cores")), 210, 25);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("Values")), 310, 25);
+
+    addSectionLabel("OUTPUT", 75);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("OutHost")), 10, 95);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("OutPort")), 110, 95);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("OutAddress")), 210, 95);
+
+    addSectionLabel("DATA STREAM", 145);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("StreamChannels")), 10, 165);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("StreamRate")), 110, 165);
+    addParameterEditor(new TextBoxParameterEditor(processor->getParameter("StreamSamples")), 210, 165);
+    addParameterEditor(new ComboBoxParameterEditor(processor->getParameter("StreamFormat")), 310, 165);
+
+    setSize(410, 215);
+    setAcquisitionActive(CoreServices::getAcquisitionStatus());
+}
+
+void OSCSettingsPanel::addSectionLabel(const String& name, int y)
+{
+    Label* label = m_sectionLabels.add(new Label(name + " Label", name));
+    label->setFont(Font("Silkscreen", "Regular", 12.0f));
+    label->setColour(Label::textColourId, Colours::darkgrey);
+    label->setBounds(10, y, 200, 20);
+    addAndMakeVisible(label);
+}
+
+void OSCSettingsPanel::addParameterEditor(ParameterEditor* parameterEditor, int x, int y)
+{
+    m_parameterEditors.add(parameterEditor);
+    parameterEditor->setTopLeftPosition(x, y);
+    parameterEditor->updateView();
+    addAndMakeVisible(parameterEditor);
+}
+
+void OSCSettingsPanel::setAcquisitionActive(bool isActive)
+{
+    for (auto parameterEditor : m_parameterEditors)
+        parameterEditor->setEnabled(!isActive || !parameterEditor->shouldDeactivateDuringAcquisition());
+}
+
 OSCEventsEditor::OSCEventsEditor(GenericProcessor *parentNode)
     : GenericEditor(parentNode)
 {
-    desiredWidth = 250;
+    desiredWidth = 360;
 
     ipLabel = std::make_unique<Label>("IP Label", "IP");
     ipLabel->setFont(Font("Silkscreen", "Regular", 12.0f));
@@ -48,6 +94,14 @@ OSCEventsEditor::OSCEventsEditor(GenericProcessor *parentNode)
     addTextBoxParameterEditor("Port", 160, 25);
     addTextBoxParameterEditor("Address", 15, 75);
     addTextBoxParameterEditor("Duration", 105, 75);
+
+    // routes, listener threads, value channels, output and data stream
+    settingsButton = std::make_unique<TextButton>("Settings Button");
+    settingsButton->setBounds(255, 25, 90, 18);
+    settingsButton->addListener(this);
+    settingsButton->setButtonText("SETTINGS");
+    settingsButton->setTooltip("Routes, listener threads, value channels, OSC output and data stream");
+    addAndMakeVisible(settingsButton.get());
     
      // Stimulate (toggle)
     stimLabel = std::make_unique<Label>("Stim Label", "STIM");
@@ -64,14 +118,75 @@ OSCEventsEditor::OSCEventsEditor(GenericProcessor *parentNode)
     stimulationToggleButton->setColour(TextButton::buttonOnColourId, Colours::yellow);
     stimulationToggleButton->setToggleState(true, dontSendNotification);
     addAndMakeVisible(stimulationToggleButton.get()); // makes the button a child component of the editor and makes it visible
+
+    // live receive stats, also available through the STATS_QUERY_ADDRESS OSC query
+    statsText = std::make_unique<Label>("Stats", "");
+    statsText->setFont(Font("CP Mono", "Plain", 12.0f));
+    statsText->setColour(Label::textColourId, Colours::darkgrey);
+    statsText->setJustificationType(Justification::topLeft);
+    statsText->setBounds(255, 48, 100, 70);
+    addAndMakeVisible(statsText.get());
+
+    startTimer(500);
+}
+
+void OSCEventsEditor::timerCallback()
+{
+    OSCEventsNode *processor = (OSCEventsNode *) getProcessor();
+    const OSCStats& stats = processor->getStats();
+    const LatencyHistogram& latency = stats.arrivalToEmitNs;
+
+    double nowMs = Time::getMillisecondCounterHiRes();
+    uint64 messagesReceived = stats.messagesReceived.load();
+
+    double rate = 0.0;
+
+    if (m_lastRefreshMs > 0.0 && nowMs > m_lastRefreshMs && messagesReceived >= m_lastMessagesReceived)
+        rate = (messagesReceived - m_lastMessagesReceived) * 1000.0 / (nowMs - m_lastRefreshMs);
+
+    m_lastMessagesReceived = messagesReceived;
+    m_lastRefreshMs = nowMs;
+
+    String text;
+    text << "RX   " << String(rate, 0) << "/s\n";
+    text << "BAD  " << (int64) (stats.malformedPackets.load() + stats.truncatedPackets.load()) << "\n";
+    text << "DROP " << (int64) (stats.queueDrops.load() + stats.payloadDrops.load() + stats.schedulerDrops.load()) << "\n";
+    text << "P50  " << String(latency.getValueAtPercentile(0.5) * 1e-3, 1) << " us\n";
+    text << "P99  " << String(latency.getValueAtPercentile(0.99) * 1e-3, 1) << " us";
+
+    statsText->setText(text, dontSendNotification);
+}
+
+
+void OSCEventsEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    if (m_settingsPanel != nullptr)
+        m_settingsPanel->setAcquisitionActive(true);
 }
 
+void OSCEventsEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    if (m_settingsPanel != nullptr)
+        m_settingsPanel->setAcquisitionActive(false);
+}
 
 void OSCEventsEditor::buttonClicked(Button *btn)
 {
     OSCEventsNode *processor = (OSCEventsNode *) getProcessor();
 
-    if (btn == stimulationToggleButton.get())
+    if (btn == settingsButton.get())
+    {
+        // the call-out box owns the panel and deletes it when dismissed
+        auto panel = std::make_unique<OSCSettingsPanel>(processor);
+        m_settingsPanel = panel.get();
+
+        CallOutBox::launchAsynchronously(std::move(panel), settingsButton->getScreenBounds(), nullptr);
+    }
+    else if (btn == stimulationToggleButton.get())
     {
         if (btn->getToggleState()==true)
         {
@@ -27,8 +27,37 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <VisualizerEditorHeaders.h>
 
+/**
+	Settings that are rarely changed once set up: routes, listener threads,
+	value channels, OSC output and the data stream. Opened in a call-out box
+	from the editor's SETTINGS button, so the editor itself stays compact.
+*/
+class OSCSettingsPanel : public Component
+{
+public:
+	/** Constructor */
+	OSCSettingsPanel(GenericProcessor* processor);
+
+	/** Destructor */
+	~OSCSettingsPanel() {}
+
+	/** Disables the parameters that cannot change during acquisition */
+	void setAcquisitionActive(bool isActive);
+
+private:
+
+	void addSectionLabel(const String& name, int y);
+	void addParameterEditor(ParameterEditor* parameterEditor, int x, int y);
+
+	OwnedArray<Label> m_sectionLabels;
+	OwnedArray<ParameterEditor> m_parameterEditors;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCSettingsPanel);
+};
+
 class OSCEventsEditor : public GenericEditor,
-						public Button::Listener
+						public Button::Listener,
+						public Timer
 {
 public:
 	/** Constructor */
@@ -43,6 +72,15 @@ public:
 	/** Update editor settings */
 	void updateSettings() override;
 
+	/** Refreshes the stats panel */
+	void timerCallback() override;
+
+	/** Disables the settings panel's acquisition-bound parameters */
+	void startAcquisition() override;
+
+	/** Re-enables them */
+	void stopAcquisition() override;
+
 private:
 
 	std::unique_ptr<TextButton> stimulationToggleButton;
@@ -51,6 +89,15 @@ private:
 	std::unique_ptr<Label> ipLabel;
 	std::unique_ptr<TextEditor> ipAddrLabel;
 
+	std::unique_ptr<TextButton> settingsButton;
+	Component::SafePointer<OSCSettingsPanel> m_settingsPanel;
+
+	std::unique_ptr<Label> statsText;
+
+	/** Counter values at the previous refresh, for rates */
+	uint64 m_lastMessagesReceived = 0;
+	double m_lastRefreshMs = 0.0;
+
 	/** Generates an assertion if this class leaks */
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCEventsEditor);
 };
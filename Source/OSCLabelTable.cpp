@@ -0,0 +1,87 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCLabelTable.h"
+
+#include <algorithm>
+#include <cstring>
+
+OSCLabelTable::OSCLabelTable(int capacity, int textSize)
+    : m_capacity(std::max(1, capacity))
+{
+    int numSlots = 1;
+
+    while (numSlots < 2 * m_capacity)
+        numSlots *= 2;
+
+    m_labels.reserve(m_capacity);
+    m_slots.resize(numSlots);
+    m_text.resize(std::max(1, textSize));
+
+    clear();
+}
+
+int OSCLabelTable::intern(const char* text, bool& added)
+{
+    added = false;
+
+    // FNV-1a, hashed while the length is found
+    uint32_t hash = 2166136261u;
+    int length = 0;
+
+    for (; text[length] != 0; length++)
+        hash = (hash ^ (uint8_t) text[length]) * 16777619u;
+
+    const uint32_t mask = (uint32_t) m_slots.size() - 1;
+    uint32_t slot = hash & mask;
+
+    // linear probing; the table is at most half full, so an empty slot ends the search
+    for (; m_slots[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        const Label& label = m_labels[m_slots[slot]];
+
+        if (label.hash == hash && label.length == length
+            && std::memcmp(&m_text[label.offset], text, (size_t) length) == 0)
+            return m_slots[slot];
+    }
+
+    if ((int) m_labels.size() >= m_capacity || m_textUsed + length + 1 > (int) m_text.size())
+        return -1;
+
+    const int id = (int) m_labels.size();
+
+    std::memcpy(&m_text[m_textUsed], text, (size_t) length + 1);
+    m_labels.push_back({ hash, m_textUsed, length });
+    m_textUsed += length + 1;
+
+    m_slots[slot] = id;
+    added = true;
+
+    return id;
+}
+
+void OSCLabelTable::clear()
+{
+    m_labels.clear();
+    std::fill(m_slots.begin(), m_slots.end(), -1);
+    m_textUsed = 0;
+}
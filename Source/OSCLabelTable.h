@@ -0,0 +1,80 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCLABELTABLE_H
+#define OSCLABELTABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#define LABEL_TABLE_CAPACITY 4096
+#define LABEL_TABLE_TEXT_SIZE (256 * 1024)
+
+/**
+	Interning table for the strings of text routes (trial labels,
+	condition names): each distinct string gets a small integer id, so a
+	label that repeats is looked up instead of copied again.
+
+	An open addressing hash table over a character arena, both reserved
+	in the constructor; intern() never allocates. Once the table or the
+	arena is full, new strings are refused. Not thread safe: one thread
+	owns a table.
+*/
+class OSCLabelTable
+{
+public:
+
+	/** Constructor -- room for capacity labels of textSize characters in total */
+	explicit OSCLabelTable(int capacity = LABEL_TABLE_CAPACITY, int textSize = LABEL_TABLE_TEXT_SIZE);
+
+	/** Returns the id of a NUL terminated string, adding it if it is new
+		(added is set), or -1 if it is new and the table is full */
+	int intern(const char* text, bool& added);
+
+	/** A label's characters (NUL terminated) and length */
+	const char* getText(int id) const { return &m_text[m_labels[id].offset]; }
+	int getLength(int id) const { return m_labels[id].length; }
+
+	/** Returns the number of labels */
+	int getNumLabels() const { return (int) m_labels.size(); }
+
+	/** Forgets all labels */
+	void clear();
+
+private:
+
+	struct Label
+	{
+		uint32_t hash;
+		int offset;
+		int length;
+	};
+
+	int m_capacity;
+
+	std::vector<Label> m_labels;
+	std::vector<int> m_slots; // label id, or -1; a power of two, at least twice the capacity
+	std::vector<char> m_text;
+	int m_textUsed = 0;
+};
+
+#endif
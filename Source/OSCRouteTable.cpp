@@ -0,0 +1,173 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCRouteTable.h"
+
+#include <cstdlib>
+#include <sstream>
+
+static bool parseInt(const std::string& text, int minValue, int& value)
+{
+    if (text.empty())
+        return false;
+
+    char* end = nullptr;
+    long result = std::strtol(text.c_str(), &end, 10);
+
+    if (*end != '\0' || result < minValue || result > 0x7FFFFFFF)
+        return false;
+
+    value = (int) result;
+    return true;
+}
+
+bool OSCRouteTable::parseRoute(const std::string& text, OSCRoute& route, std::string& error)
+{
+    std::istringstream tokens(text);
+    std::string token;
+
+    route = OSCRoute();
+
+    if (!(tokens >> route.address) || route.address[0] != '/')
+    {
+        error = "route must start with an OSC address: '" + text + "'";
+        return false;
+    }
+
+    while (tokens >> token)
+    {
+        size_t separator = token.find('=');
+        std::string key = token.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : token.substr(separator + 1);
+
+        bool valid = true;
+
+        if (key == "line")
+            valid = parseInt(value, 0, route.ttlLine) && route.ttlLine < 256;
+        else if (key == "stream")
+            valid = value == "all" ? (route.streamIndex = -1, true) : parseInt(value, 0, route.streamIndex);
+        else if (key == "duration")
+            valid = parseInt(value, 0, route.durationMs);
+        else if (key == "mode")
+        {
+            if (value == "pulse")
+                route.mode = OSCRoute::PULSE;
+            else if (value == "state")
+                route.mode = OSCRoute::STATE;
+            else if (value == "on")
+                route.mode = OSCRoute::ON;
+            else if (value == "off")
+                route.mode = OSCRoute::OFF;
+            else if (value == "value")
+                route.mode = OSCRoute::VALUE;
+            else if (value == "text")
+                route.mode = OSCRoute::TEXT;
+            else
+                valid = false;
+        }
+        else if (key == "channel")
+            valid = parseInt(value, 0, route.valueChannel);
+        else if (key == "interp")
+        {
+            if (value == "hold")
+                route.interpolate = false;
+            else if (value == "linear")
+                route.interpolate = true;
+            else
+                valid = false;
+        }
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            error = "invalid setting '" + token + "' for route " + route.address;
+            return false;
+        }
+    }
+
+    // the audio thread reads the values and strings from the message itself
+    route.keepMessage = route.mode == OSCRoute::VALUE || route.mode == OSCRoute::TEXT;
+
+    return true;
+}
+
+std::string OSCRouteTable::addRoutes(const std::string& text)
+{
+    std::string errors;
+    std::istringstream entries(text);
+    std::string entry;
+
+    while (std::getline(entries, entry, ';'))
+    {
+        if (entry.find_first_not_of(" \t\r\n") == std::string::npos)
+            continue;
+
+        OSCRoute route;
+        std::string error;
+
+        if (parseRoute(entry, route, error))
+            addRoute(route);
+        else
+            errors += (errors.empty() ? "" : "; ") + error;
+    }
+
+    return errors;
+}
+
+void OSCRouteTable::addRoute(const OSCRoute& route)
+{
+    m_routes.push_back(route);
+}
+
+void OSCRouteTable::compile()
+{
+    m_matcher.clear();
+
+    std::vector<int> addressOfRoute;
+    m_keepsMessages = false;
+
+    for (const OSCRoute& route : m_routes)
+    {
+        addressOfRoute.push_back(m_matcher.addAddress(route.address));
+        m_keepsMessages = m_keepsMessages || route.keepMessage;
+    }
+
+    m_matcher.compile();
+
+    // group routes by address so dispatch() can walk a contiguous range
+    int numAddresses = m_matcher.getNumAddresses();
+
+    m_addressRouteStart.assign(numAddresses + 1, 0);
+    m_routeOrder.assign(m_routes.size(), 0);
+
+    for (int address : addressOfRoute)
+        m_addressRouteStart[address + 1]++;
+
+    for (int i = 0; i < numAddresses; i++)
+        m_addressRouteStart[i + 1] += m_addressRouteStart[i];
+
+    std::vector<int> next(m_addressRouteStart.begin(), m_addressRouteStart.end() - 1);
+
+    for (int route = 0; route < (int) m_routes.size(); route++)
+        m_routeOrder[next[addressOfRoute[route]]++] = route;
+}
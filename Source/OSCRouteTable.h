@@ -0,0 +1,126 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCROUTETABLE_H
+#define OSCROUTETABLE_H
+
+#include "OSCAddressMatcher.h"
+
+#include <string>
+#include <vector>
+
+/** Maps one OSC address onto a TTL line and stream, onto value channels or onto text events */
+struct OSCRoute
+{
+	enum Mode
+	{
+		PULSE, // pulse of durationMs (state taken from the arguments if the duration is 0)
+		STATE, // on/off taken from the arguments, no automatic turn-off
+		ON,    // always turns the line on
+		OFF,   // always turns the line off
+		VALUE, // numeric arguments are written into value channels, starting at valueChannel
+		TEXT   // string and symbol arguments become text events, numeric arguments their metadata
+	};
+
+	std::string address;
+	int ttlLine = -1;     // -1: line taken from the first argument
+	int streamIndex = -1; // -1: all streams
+	int durationMs = -1;  // -1: the processor's pulse duration
+	Mode mode = PULSE;
+	int valueChannel = 0; // VALUE: channel of the first argument
+	bool interpolate = false; // VALUE: ramp between updates instead of holding
+
+	/** The message itself is handed to the audio thread, as a view of the
+		packet slab it was received into (see PacketSlabPool) */
+	bool keepMessage = false;
+};
+
+/**
+	Set of routes, compiled for allocation-free lookup on the OSC listener thread.
+
+	Routes are written as
+		<address> [line=<n>] [stream=<n>] [duration=<ms>] [mode=pulse|state|on|off]
+		<address> mode=value [channel=<n>] [interp=hold|linear] [stream=<n>]
+		<address> mode=text [stream=<n>]
+	and separated by ';'. Several routes may share an address.
+*/
+class OSCRouteTable
+{
+public:
+
+	/** Constructor */
+	OSCRouteTable() : m_matcher(false) { }
+
+	/** Parses one route, returns false and fills error if it is invalid */
+	static bool parseRoute(const std::string& text, OSCRoute& route, std::string& error);
+
+	/** Parses a ';'-separated list of routes and adds the valid ones,
+		returns a description of any invalid entries (empty if all were valid) */
+	std::string addRoutes(const std::string& text);
+
+	/** Adds a route */
+	void addRoute(const OSCRoute& route);
+
+	/** Builds the lookup structures, call after adding routes */
+	void compile();
+
+	/** Returns the number of routes */
+	int getNumRoutes() const { return (int) m_routes.size(); }
+
+	/** Returns a route */
+	const OSCRoute& getRoute(int index) const { return m_routes[index]; }
+
+	/** True if any route keeps its messages, so packets must be received into slabs */
+	bool keepsMessages() const { return m_keepsMessages; }
+
+	/** Calls callback(const OSCRoute&) for every route matching an incoming
+		address pattern, returns the number of routes matched */
+	template <typename Callback>
+	int dispatch(const char* addressPattern, Callback&& callback)
+	{
+		int numRoutes = 0;
+
+		m_matcher.match(addressPattern, [&](int addressIndex)
+		{
+			for (int i = m_addressRouteStart[addressIndex]; i < m_addressRouteStart[addressIndex + 1]; i++)
+			{
+				callback(m_routes[m_routeOrder[i]]);
+				numRoutes++;
+			}
+		});
+
+		return numRoutes;
+	}
+
+private:
+
+	std::vector<OSCRoute> m_routes;
+	bool m_keepsMessages = false;
+
+	OSCAddressMatcher m_matcher;
+
+	// routes of address i are m_routeOrder[m_addressRouteStart[i] .. m_addressRouteStart[i + 1])
+	std::vector<int> m_addressRouteStart;
+	std::vector<int> m_routeOrder;
+};
+
+#endif
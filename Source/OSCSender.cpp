@@ -0,0 +1,114 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCSender.h"
+#include "oscpack/osc/OscOutboundPacketStream.h"
+
+OSCSender::OSCSender(String host, int port, String address)
+    : Thread("OscSender Thread"),
+      m_host(host),
+      m_port(port),
+      m_address(address.toStdString()),
+      m_eventQueue(OUTPUT_QUEUE_SIZE)
+{
+    LOGC("Creating OSC sender - Host:", host, " Port:", port, " Address:", address);
+
+    try
+    {
+        m_socket = std::make_unique<UdpTransmitSocket>(
+            IpEndpointName(m_host.toRawUTF8(), m_port));
+    }
+    catch (const std::exception &e)
+    {
+        LOGE("Exception in creating OSC sender: ", String(e.what()));
+    }
+}
+
+OSCSender::~OSCSender()
+{
+    stopThread(100);
+}
+
+void OSCSender::run()
+{
+    while (!threadShouldExit())
+    {
+        // the audio thread never signals us, so poll at a short interval while idle
+        if (!sendPendingEvents())
+            wait(1);
+    }
+
+    // flush whatever was queued before acquisition stopped
+    while (sendPendingEvents())
+        ;
+}
+
+bool OSCSender::sendPendingEvents()
+{
+    if (!m_socket || m_eventQueue.front() == nullptr)
+        return false;
+
+    // bytes added per message inside a bundle: size prefix, padded address, ",iihi" tag and arguments
+    const std::size_t messageSize = 4 + ((m_address.size() + 4) & ~std::size_t(3)) + 8 + 20;
+
+    try
+    {
+        osc::OutboundPacketStream packet(m_packetBuffer, OUTPUT_PACKET_SIZE);
+
+        const bool isBundle = m_eventQueue.count() > 1;
+
+        if (isBundle)
+            packet << osc::BeginBundleImmediate;
+
+        OutputEventData event;
+
+        do
+        {
+            m_eventQueue.pop(event);
+
+            packet << osc::BeginMessage(m_address.c_str())
+                   << (osc::int32) event.ttlLine
+                   << (osc::int32) event.state
+                   << (osc::int64) event.sampleNumber
+                   << (osc::int32) event.streamId
+                   << osc::EndMessage;
+        }
+        while (isBundle
+               && packet.Capacity() - packet.Size() >= messageSize
+               && m_eventQueue.front() != nullptr);
+
+        if (isBundle)
+            packet << osc::EndBundle;
+
+        m_socket->Send(packet.Data(), packet.Size());
+        m_packetsSent++;
+    }
+    catch (osc::Exception &e)
+    {
+        // only an address that does not fit in a packet ends up here
+        LOGE("Unable to serialise OSC output message: ", String(e.what()));
+        m_eventQueue.clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCSENDER_H
+#define OSCSENDER_H
+
+#include <ProcessorHeaders.h>
+#include "LockFreeQueue.h"
+#include "oscpack/ip/UdpSocket.h"
+
+#define DEFAULT_OUTPUT_ADDRESS "/ttl/out"
+#define OUTPUT_QUEUE_SIZE 4096
+#define OUTPUT_PACKET_SIZE 1024
+
+/** A TTL event seen in the signal chain, waiting to be sent */
+struct OutputEventData
+{
+	int64 sampleNumber;
+	uint16 streamId;
+	uint8 ttlLine;
+	bool state;
+};
+
+/**
+	Sends TTL events as OSC messages from a dedicated thread.
+
+	The audio thread only copies events into a lock-free queue; packets
+	are serialised into a preallocated buffer and sent on this thread,
+	so process() never blocks on the network. Events that pile up between
+	two wakeups are sent together in one bundle.
+
+	Each message is <address> <int32 line> <int32 state> <int64 sample number> <int32 stream id>.
+*/
+class OSCSender : public Thread
+{
+public:
+
+	/** Constructor */
+	OSCSender(String host, int port, String address);
+
+	/** Destructor */
+	~OSCSender();
+
+	/** Called from the audio thread, returns false (and counts a drop) if the queue is full */
+	bool push(const OutputEventData& event) { return m_eventQueue.push(event); }
+
+	/** True if the destination could be resolved and the socket was created */
+	bool isConnected() const { return m_socket != nullptr; }
+
+	/** Returns the number of events dropped because the queue was full */
+	uint64 getDroppedCount() const { return m_eventQueue.getDroppedCount(); }
+
+	/** Returns the number of packets sent */
+	uint64 getPacketsSent() const { return m_packetsSent; }
+
+	/** Thread loop */
+	void run() override;
+
+private:
+
+	/** Sends everything in the queue, returns false if it was empty */
+	bool sendPendingEvents();
+
+	String m_host;
+	int m_port;
+	std::string m_address;
+
+	std::unique_ptr<UdpTransmitSocket> m_socket;
+	LockFreeQueue<OutputEventData> m_eventQueue;
+
+	char m_packetBuffer[OUTPUT_PACKET_SIZE];
+
+	std::atomic<uint64> m_packetsSent { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCSender);
+};
+
+#endif
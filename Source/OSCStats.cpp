@@ -0,0 +1,144 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCStats.h"
+
+#include <initializer_list>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    /** Index of the highest set bit, value must be non-zero */
+    int highestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return (int) index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    const uint64_t maxTrackableValue = (uint64_t(1) << LATENCY_MAX_VALUE_BITS) - 1;
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+int LatencyHistogram::getBucketIndex(uint64_t value)
+{
+    if (value > maxTrackableValue)
+        value = maxTrackableValue;
+
+    // values below SUB_BUCKETS are exact; above, each power of two range
+    // [2^k, 2^(k+1)) keeps its top LATENCY_SUB_BUCKET_BITS + 1 bits
+    if (value < (uint64_t) SUB_BUCKETS)
+        return (int) value;
+
+    int shift = highestBit(value) - LATENCY_SUB_BUCKET_BITS;
+
+    return shift * (SUB_BUCKETS / 2) + (int) (value >> shift);
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(int index)
+{
+    if (index < SUB_BUCKETS)
+        return (uint64_t) index;
+
+    int shift = index / (SUB_BUCKETS / 2) - 1;
+    uint64_t subBucket = (uint64_t) (index % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2);
+
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+    m_buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        ;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(double fraction) const
+{
+    uint64_t count = getCount();
+
+    if (count == 0)
+        return 0;
+
+    uint64_t target = (uint64_t) (fraction * count + 0.5);
+
+    if (target < 1)
+        target = 1;
+
+    uint64_t seen = 0;
+
+    for (int i = 0; i < NUM_BUCKETS; i++)
+    {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+
+        if (seen >= target)
+        {
+            // never report more than was actually recorded
+            uint64_t upperBound = getBucketUpperBound(i);
+            return upperBound < getMax() ? upperBound : getMax();
+        }
+    }
+
+    return getMax();
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t OSCStats::getQueueDepth() const
+{
+    uint64_t queued = messagesQueued.load(std::memory_order_relaxed);
+    uint64_t processed = messagesProcessed.load(std::memory_order_relaxed);
+
+    return queued > processed ? queued - processed : 0;
+}
+
+void OSCStats::reset()
+{
+    for (auto counter : { &packetsReceived, &malformedPackets, &messagesReceived, &unmatchedMessages,
+                          &messagesQueued, &queueDrops, &messagesProcessed, &eventsEmitted, &schedulerDrops,
+                          &truncatedPackets, &payloadDrops })
+        counter->store(0, std::memory_order_relaxed);
+
+    arrivalToEmitNs.reset();
+}
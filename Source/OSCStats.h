@@ -0,0 +1,122 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCSTATS_H
+#define OSCSTATS_H
+
+#include <atomic>
+#include <cstdint>
+
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_MAX_VALUE_BITS 40 // ~18 minutes in nanoseconds
+
+/**
+	Log-linear latency histogram in the style of HdrHistogram.
+
+	Each power of two range is split into 16 linear sub-buckets, so any
+	recorded value is reported with at most 1/16 (6.25 %) relative error,
+	from nanoseconds up to minutes, in a fixed 4.7 KB table. Larger values
+	are clamped.
+
+	record() is lock-free and never allocates; it may be called from any
+	thread while others read percentiles.
+*/
+class LatencyHistogram
+{
+public:
+
+	/** Constructor */
+	LatencyHistogram();
+
+	/** Adds one value (e.g. nanoseconds) */
+	void record(uint64_t value);
+
+	/** Smallest value v such that at least fraction (0..1) of the recorded values are <= v,
+		to the histogram's precision; 0 if nothing was recorded */
+	uint64_t getValueAtPercentile(double fraction) const;
+
+	/** Returns the largest recorded value */
+	uint64_t getMax() const { return m_max.load(std::memory_order_relaxed); }
+
+	/** Returns the number of recorded values */
+	uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); }
+
+	/** Forgets all recorded values */
+	void reset();
+
+	static const int SUB_BUCKETS = 1 << (LATENCY_SUB_BUCKET_BITS + 1);
+	static const int NUM_BUCKETS = (LATENCY_MAX_VALUE_BITS - LATENCY_SUB_BUCKET_BITS + 1) * (SUB_BUCKETS / 2);
+
+	/** Bucket of a value, and the highest value that falls into a bucket */
+	static int getBucketIndex(uint64_t value);
+	static uint64_t getBucketUpperBound(int index);
+
+private:
+
+	std::atomic<uint64_t> m_buckets[NUM_BUCKETS];
+	std::atomic<uint64_t> m_count;
+	std::atomic<uint64_t> m_max;
+};
+
+/**
+	Counters for the OSC receive path, written by the listener thread
+	(packets, messages) and the audio thread (processing, latency), and
+	read by the editor and the stats query at any time.
+
+	Counters are relaxed atomics: each one is exact, but a snapshot of
+	several may be taken mid-update.
+*/
+struct OSCStats
+{
+	/** Listener thread */
+	std::atomic<uint64_t> packetsReceived { 0 };
+	std::atomic<uint64_t> malformedPackets { 0 };
+	std::atomic<uint64_t> truncatedPackets { 0 };   // larger than RECEIVE_BUFFER_SIZE
+	std::atomic<uint64_t> messagesReceived { 0 };
+	std::atomic<uint64_t> unmatchedMessages { 0 };  // no route for the address
+	std::atomic<uint64_t> messagesQueued { 0 };
+	std::atomic<uint64_t> queueDrops { 0 };
+	std::atomic<uint64_t> payloadDrops { 0 };  // no packet slab for a route that keeps its messages
+
+	/** Audio thread */
+	std::atomic<uint64_t> messagesProcessed { 0 };
+	std::atomic<uint64_t> eventsEmitted { 0 };
+	std::atomic<uint64_t> schedulerDrops { 0 };
+
+	/** Packet arrival to the process() call that emits its events, for
+		messages that fire on arrival (not time-tagged for later) */
+	LatencyHistogram arrivalToEmitNs;
+
+	/** Messages waiting in the queue */
+	uint64_t getQueueDepth() const;
+
+	/** Resets everything, e.g. at the start of acquisition */
+	void reset();
+};
+
+/** Adds to a stats counter */
+inline void increment(std::atomic<uint64_t>& counter, uint64_t amount = 1)
+{
+	counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCStreamDecimator.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_STREAM_DECIMATOR_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OSC_STREAM_DECIMATOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+void OSCStreamDecimator::setup(int numChannels, int decimation, int framesPerPacket)
+{
+    m_numChannels = std::max(0, numChannels);
+    m_decimation = std::max(1, decimation);
+    m_framesPerPacket = std::max(1, framesPerPacket);
+
+    m_sums.assign(m_numChannels, 0.0);
+    m_frames.assign((size_t) m_numChannels * m_framesPerPacket, 0.0f);
+
+    reset();
+}
+
+void OSCStreamDecimator::reset()
+{
+    std::fill(m_sums.begin(), m_sums.end(), 0.0);
+    m_count = 0;
+    m_frame = 0;
+    m_packetStartSampleNum = 0;
+}
+
+void OSCStreamDecimator::completeFrame()
+{
+    float* frame = &m_frames[(size_t) m_frame * m_numChannels];
+
+    for (int channel = 0; channel < m_numChannels; channel++)
+    {
+        frame[channel] = float(m_sums[channel] / m_decimation);
+        m_sums[channel] = 0.0;
+    }
+
+    m_count = 0;
+    m_frame++;
+}
+
+float OSCStreamDecimator::sum(const float* values, int numValues)
+{
+    int i = 0;
+    float total = 0.0f;
+
+    // two independent accumulators hide the latency of the additions
+#if defined(OSC_STREAM_DECIMATOR_SSE2)
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+
+    for (; i + 8 <= numValues; i += 8)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_loadu_ps(values + i));
+        sum1 = _mm_add_ps(sum1, _mm_loadu_ps(values + i + 4));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(OSC_STREAM_DECIMATOR_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= numValues; i += 8)
+    {
+        sum0 = vaddq_f32(sum0, vld1q_f32(values + i));
+        sum1 = vaddq_f32(sum1, vld1q_f32(values + i + 4));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, vaddq_f32(sum0, sum1));
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for (; i < numValues; i++)
+        total += values[i];
+
+    return total;
+}
@@ -0,0 +1,112 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCSTREAMDECIMATOR_H
+#define OSCSTREAMDECIMATOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+	Decimates continuous channels for the OSC data stream: every
+	decimation input samples of a channel are averaged into one output
+	value, and every framesPerPacket output frames (one value per channel)
+	make up a packet.
+
+	Averages and packets run on across blocks of any size. The spans are
+	summed with SIMD (SSE2 or NEON) where available. Storage is reserved
+	in setup(); process() never allocates.
+*/
+class OSCStreamDecimator
+{
+public:
+
+	/** Constructor */
+	OSCStreamDecimator() { }
+
+	/** Sets the shape of the output, and restarts it */
+	void setup(int numChannels, int decimation, int framesPerPacket);
+
+	int getNumChannels() const { return m_numChannels; }
+	int getDecimation() const { return m_decimation; }
+	int getFramesPerPacket() const { return m_framesPerPacket; }
+
+	/** Averages a block of every channel (channels[0 .. getNumChannels())), starting
+		at startSampleNum. Calls onPacket(const float* frames, int64_t firstSampleNum)
+		for each completed packet: getFramesPerPacket() frames of getNumChannels()
+		values, frame by frame, and the first input sample they average */
+	template <typename Callback>
+	void process(const float* const* channels, int numSamples, int64_t startSampleNum, Callback&& onPacket)
+	{
+		int position = 0;
+
+		while (position < numSamples)
+		{
+			if (m_frame == 0 && m_count == 0)
+				m_packetStartSampleNum = startSampleNum + position;
+
+			const int numSummed = std::min(numSamples - position, m_decimation - m_count);
+
+			for (int channel = 0; channel < m_numChannels; channel++)
+				m_sums[channel] += sum(channels[channel] + position, numSummed);
+
+			m_count += numSummed;
+			position += numSummed;
+
+			if (m_count < m_decimation)
+				break;
+
+			completeFrame();
+
+			if (m_frame == m_framesPerPacket)
+			{
+				onPacket(m_frames.data(), m_packetStartSampleNum);
+				m_frame = 0;
+			}
+		}
+	}
+
+	/** Drops the partial average and packet */
+	void reset();
+
+	/** Sum of a span, exposed for benchmarking */
+	static float sum(const float* values, int numValues);
+
+private:
+
+	/** Stores the averages as the next frame and restarts them */
+	void completeFrame();
+
+	int m_numChannels = 0;
+	int m_decimation = 1;
+	int m_framesPerPacket = 1;
+
+	std::vector<double> m_sums;  // per channel, over the current average
+	int m_count = 0;             // samples in the current average
+
+	std::vector<float> m_frames; // the current packet, frame by frame
+	int m_frame = 0;             // frames in the current packet
+	int64_t m_packetStartSampleNum = 0;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCStreamSender.h"
+#include "oscpack/osc/OscOutboundPacketStream.h"
+
+OSCStreamSender::OSCStreamSender(String host, int port, bool useBlobs, int maxValues)
+    : Thread("OscStreamSender Thread"),
+      m_host(host),
+      m_port(port),
+      m_useBlobs(useBlobs),
+      m_address(DEFAULT_STREAM_ADDRESS),
+      m_pendingPackets(STREAM_PACKET_SLOTS),
+      m_freeSlots(STREAM_PACKET_SLOTS)
+{
+    LOGC("Creating OSC data stream - Host:", host, " Port:", port, " Values per packet:", maxValues);
+
+    // address, type tags (one per float argument), the five leading arguments and the values
+    m_slotSize = 128 + (int) m_address.size() + 5 * jmin(maxValues, STREAM_MAX_VALUES);
+    m_packetStorage.resize((size_t) m_slotSize * STREAM_PACKET_SLOTS);
+
+    // nothing else uses the free list yet, so this thread can act as its producer
+    for (int slot = 0; slot < STREAM_PACKET_SLOTS; slot++)
+        m_freeSlots.push(slot);
+
+    try
+    {
+        m_socket = std::make_unique<UdpTransmitSocket>(
+            IpEndpointName(m_host.toRawUTF8(), m_port));
+    }
+    catch (const std::exception &e)
+    {
+        LOGE("Exception in creating OSC data stream: ", String(e.what()));
+    }
+}
+
+OSCStreamSender::~OSCStreamSender()
+{
+    stopThread(100);
+}
+
+bool OSCStreamSender::sendFrames(uint16 streamId, int64 firstSampleNum, float sampleRate,
+                                 const float* frames, int numFrames, int numChannels)
+{
+    int slot;
+
+    if (!m_freeSlots.pop(slot))
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    StreamPacket streamPacket { slot, 0 };
+
+    try
+    {
+        // the OutboundPacketStream only wraps the preallocated buffer
+        osc::OutboundPacketStream packet(getSlot(slot), (std::size_t) m_slotSize);
+
+        packet << osc::BeginMessage(m_address.c_str())
+               << (osc::int32) streamId
+               << (osc::int64) firstSampleNum
+               << sampleRate
+               << (osc::int32) numChannels
+               << (osc::int32) numFrames;
+
+        if (m_useBlobs)
+            packet << osc::Float32Blob(frames, numFrames * numChannels);
+        else
+            packet << osc::Float32Array(frames, numFrames * numChannels);
+
+        packet << osc::EndMessage;
+
+        streamPacket.size = (int) packet.Size();
+    }
+    catch (osc::Exception&)
+    {
+        // cannot happen for packets of up to maxValues values; the
+        // buffer still goes through the sender thread to be freed
+    }
+
+    // never full: there are only as many packets as buffers
+    m_pendingPackets.push(streamPacket);
+
+    return streamPacket.size > 0;
+}
+
+void OSCStreamSender::run()
+{
+    while (!threadShouldExit())
+    {
+        // the audio thread never signals us, so poll at a short interval while idle
+        if (!sendPendingPackets())
+            wait(1);
+    }
+
+    // send whatever was packed before acquisition stopped
+    sendPendingPackets();
+}
+
+bool OSCStreamSender::sendPendingPackets()
+{
+    StreamPacket streamPacket;
+    bool sent = false;
+
+    while (m_pendingPackets.pop(streamPacket))
+    {
+        if (m_socket && streamPacket.size > 0)
+        {
+            m_socket->Send(getSlot(streamPacket.slot), (std::size_t) streamPacket.size);
+            m_packetsSent++;
+        }
+
+        m_freeSlots.push(streamPacket.slot);
+        sent = true;
+    }
+
+    return sent;
+}
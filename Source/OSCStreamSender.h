@@ -0,0 +1,109 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCSTREAMSENDER_H
+#define OSCSTREAMSENDER_H
+
+#include <ProcessorHeaders.h>
+#include "LockFreeQueue.h"
+#include "oscpack/ip/UdpSocket.h"
+
+#define DEFAULT_STREAM_ADDRESS "/oscevents/data"
+#define STREAM_PACKET_SLOTS 64
+#define STREAM_MAX_VALUES 8192 // channels x frames per packet, keeps packets below the UDP limit
+
+/** A packed packet waiting to be sent */
+struct StreamPacket
+{
+	int slot;
+	int size; // 0 if it could not be packed
+};
+
+/**
+	Sends decimated continuous data as OSC packets from a dedicated thread.
+
+	The audio thread packs each packet straight into one of a fixed set of
+	preallocated packet buffers and hands the buffer's index to the sender
+	thread, which sends it and hands the buffer back; both hand-offs are
+	lock-free queues. When every buffer is in flight the packet is dropped
+	and counted, so process() never waits for the network.
+
+	Each packet is one message:
+		<address> <int32 stream id> <int64 first sample number> <float output sample rate>
+				  <int32 channels> <int32 frames> <values>
+	with the values frame by frame, either as float32 arguments or as one
+	blob of big-endian float32.
+*/
+class OSCStreamSender : public Thread
+{
+public:
+
+	/** Constructor -- maxValues is the largest channels x frames of a packet */
+	OSCStreamSender(String host, int port, bool useBlobs, int maxValues);
+
+	/** Destructor */
+	~OSCStreamSender();
+
+	/** Audio thread: packs and queues a packet of numFrames frames of numChannels values,
+		returns false (and counts a drop) if no packet buffer is free */
+	bool sendFrames(uint16 streamId, int64 firstSampleNum, float sampleRate,
+					const float* frames, int numFrames, int numChannels);
+
+	/** True if the destination could be resolved and the socket was created */
+	bool isConnected() const { return m_socket != nullptr; }
+
+	/** Returns the number of packets dropped because every buffer was in flight */
+	uint64 getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	/** Returns the number of packets sent */
+	uint64 getPacketsSent() const { return m_packetsSent; }
+
+	/** Thread loop */
+	void run() override;
+
+private:
+
+	/** Sends every queued packet, returns false if there was none */
+	bool sendPendingPackets();
+
+	char* getSlot(int slot) { return &m_packetStorage[(size_t) slot * m_slotSize]; }
+
+	String m_host;
+	int m_port;
+	bool m_useBlobs;
+	std::string m_address;
+
+	std::unique_ptr<UdpTransmitSocket> m_socket;
+
+	/** Packet buffers, and their hand-offs: audio -> sender, sender -> audio */
+	std::vector<char> m_packetStorage;
+	int m_slotSize;
+	LockFreeQueue<StreamPacket> m_pendingPackets;
+	LockFreeQueue<int> m_freeSlots;
+
+	std::atomic<uint64> m_dropped { 0 };
+	std::atomic<uint64> m_packetsSent { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCStreamSender);
+};
+
+#endif
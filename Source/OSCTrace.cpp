@@ -0,0 +1,168 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCTrace.h"
+#include "oscpack/ip/UdpSocket.h"
+
+#include <algorithm>
+
+OSCTrace::OSCTrace(int numListeners)
+    : Thread("OSC Trace Thread")
+{
+    for (int source = 0; source < LISTENER + numListeners; source++)
+        m_rings.push_back(std::make_unique<LockFreeQueue<TraceRecord>>(TRACE_RING_SIZE));
+
+    m_pending.reserve(m_rings.size() * TRACE_RING_SIZE);
+    m_reportedDrops.resize(m_rings.size(), 0);
+}
+
+OSCTrace::~OSCTrace()
+{
+    stopThread(1000);
+
+    // the producers are gone by now, so this thread can drain the rings
+    flush();
+}
+
+void OSCTrace::record(int source, TraceEvent event,
+                      int64 value0, int64 value1, int64 value2,
+                      const char* text, const char* detail)
+{
+    TraceRecord record;
+
+    record.timeNs = GetPacketClockNanoseconds();
+    record.event = event;
+    record.values[0] = value0;
+    record.values[1] = value1;
+    record.values[2] = value2;
+    record.detail = detail;
+
+    int length = 0;
+
+    if (text != nullptr)
+    {
+        while (length < TRACE_TEXT_SIZE - 1 && text[length] != 0)
+        {
+            record.text[length] = text[length];
+            length++;
+        }
+    }
+
+    record.text[length] = 0;
+
+    m_rings[source]->push(record);
+}
+
+void OSCTrace::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(TRACE_FLUSH_INTERVAL_MS);
+        flush();
+    }
+}
+
+void OSCTrace::flush()
+{
+    TraceRecord record;
+
+    for (int source = 0; source < (int) m_rings.size(); source++)
+    {
+        while (m_rings[source]->pop(record))
+            m_pending.emplace_back(record, source);
+    }
+
+    std::stable_sort(m_pending.begin(), m_pending.end(),
+                     [](const std::pair<TraceRecord, int>& a, const std::pair<TraceRecord, int>& b)
+                     {
+                         return a.first.timeNs < b.first.timeNs;
+                     });
+
+    for (const auto& pending : m_pending)
+        LOGD(format(pending.first, pending.second));
+
+    m_pending.clear();
+
+    for (int source = 0; source < (int) m_rings.size(); source++)
+    {
+        const uint64 drops = m_rings[source]->getDroppedCount();
+
+        if (drops != m_reportedDrops[source])
+        {
+            LOGD("[OSC trace] ", (int64) (drops - m_reportedDrops[source]),
+                 " records dropped from a full ring (source ", source, ")");
+
+            m_reportedDrops[source] = drops;
+        }
+    }
+}
+
+String OSCTrace::format(const TraceRecord& record, int source) const
+{
+    // UTC time of day with microseconds, to line up with packet captures
+    const uint64 microseconds = (record.timeNs / 1000) % (86400ULL * 1000000ULL);
+
+    String line = String::formatted("[OSC trace] %02d:%02d:%02d.%06d ",
+                                    (int) (microseconds / 3600000000ULL),
+                                    (int) (microseconds / 60000000ULL % 60),
+                                    (int) (microseconds / 1000000ULL % 60),
+                                    (int) (microseconds % 1000000ULL));
+
+    line += source == AUDIO ? String("audio      ") : "listener " + String(source - LISTENER) + " ";
+
+    const String text(record.text);
+    const int64* v = record.values;
+
+    switch (record.event)
+    {
+    case TRACE_MESSAGE_RECEIVED:
+        return line + "message " + text + " (" + String(v[0]) + " arguments)";
+    case TRACE_MESSAGE_ROUTED:
+        return line + "routed " + text + " -> line " + String(v[0]) + " state " + String(v[1]);
+    case TRACE_VALUES_ROUTED:
+        return line + "routed " + text + " -> value channel " + String(v[0]);
+    case TRACE_TEXT_ROUTED:
+        return line + "routed " + text + " -> text";
+    case TRACE_MESSAGE_IGNORED:
+        return line + "ignoring " + text + ": unexpected argument types (" + String(v[0]) + " arguments)";
+    case TRACE_MALFORMED_PACKET:
+        return line + "ignoring malformed packet: " + String(record.detail != nullptr ? record.detail : "");
+    case TRACE_TRUNCATED_PACKET:
+        return line + "dropped packet larger than the " + String(v[0]) + " byte receive buffer";
+    case TRACE_QUEUE_FULL:
+        return line + "message queue full, dropped message for line " + String(v[0]);
+    case TRACE_PAYLOAD_DROPPED:
+        return line + "no packet slab (too large or all in use), dropped message " + text;
+    case TRACE_EDGE_SCHEDULED:
+        return line + "scheduled line " + String(v[0]) + " state " + String(v[1]) + " at sample " + String(v[2]);
+    case TRACE_PULSE_SCHEDULED:
+        return line + "scheduled pulse on line " + String(v[0]) + " for " + String(v[1]) + " samples at sample " + String(v[2]);
+    case TRACE_VALUE_SCHEDULED:
+        return line + "scheduled value " + String(v[1] / 1000.0, 3) + " on channel " + String(v[0]) + " at sample " + String(v[2]);
+    case TRACE_EVENT_EMITTED:
+        return line + "emitted line " + String(v[0]) + " state " + String(v[1]) + " at sample " + String(v[2]);
+    case TRACE_TEXT_EMITTED:
+        return line + "emitted text '" + text + "' (label " + String(v[0]) + ", " + String(v[1]) + " values) at sample " + String(v[2]);
+    }
+
+    return line;
+}
@@ -0,0 +1,132 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCTRACE_H
+#define OSCTRACE_H
+
+#include <ProcessorHeaders.h>
+#include "LockFreeQueue.h"
+
+/** Tracing is compiled in for debug builds only, unless set explicitly (e.g. -DOSC_TRACE_ENABLED=1) */
+#ifndef OSC_TRACE_ENABLED
+#ifdef NDEBUG
+#define OSC_TRACE_ENABLED 0
+#else
+#define OSC_TRACE_ENABLED 1
+#endif
+#endif
+
+#define TRACE_RING_SIZE 4096
+#define TRACE_FLUSH_INTERVAL_MS 100
+#define TRACE_TEXT_SIZE 24
+
+/** Adds a trace record, compiles to nothing when tracing is disabled:
+	OSC_TRACE(trace, LISTENER, TRACE_MESSAGE_RECEIVED, numArgs, 0, 0, address) */
+#if OSC_TRACE_ENABLED
+#define OSC_TRACE(trace, source, ...) (trace).record(OSCTrace::source, __VA_ARGS__)
+#else
+#define OSC_TRACE(trace, source, ...) ((void) 0)
+#endif
+
+/** What a trace record describes; the meaning of its values is listed for each */
+enum TraceEvent : uint16
+{
+	TRACE_MESSAGE_RECEIVED,   // argument count; text: address
+	TRACE_MESSAGE_ROUTED,     // line, state; text: address
+	TRACE_VALUES_ROUTED,      // first value channel; text: address
+	TRACE_TEXT_ROUTED,        // text: address
+	TRACE_MESSAGE_IGNORED,    // argument count; text: address
+	TRACE_MALFORMED_PACKET,   // detail: error
+	TRACE_TRUNCATED_PACKET,   // receive buffer size
+	TRACE_QUEUE_FULL,         // line
+	TRACE_PAYLOAD_DROPPED,    // text: address
+	TRACE_EDGE_SCHEDULED,     // line, state, sample number
+	TRACE_PULSE_SCHEDULED,    // line, duration in samples, sample number
+	TRACE_VALUE_SCHEDULED,    // value channel, value x 1000, sample number
+	TRACE_EVENT_EMITTED,      // line, state, sample number
+	TRACE_TEXT_EMITTED        // label id, number of values, sample number; text: label
+};
+
+/** A fixed-size binary trace record, formatted only when it is flushed */
+struct TraceRecord
+{
+	uint64 timeNs;            // packet clock
+	TraceEvent event;
+	int64 values[3];
+	const char* detail;       // string literal, or nullptr
+	char text[TRACE_TEXT_SIZE]; // start of a string that does not outlive the call, NUL terminated
+};
+
+/**
+	Lock-free replacement for logging on the per-packet hot path.
+
+	record() copies a fixed-size binary record into a preallocated ring,
+	one ring per producing thread (the audio thread and each listener
+	thread), without formatting, allocating or
+	locking; records are dropped (and counted) when a ring is full. A
+	background thread merges the rings by time and writes them to the
+	log every TRACE_FLUSH_INTERVAL_MS.
+*/
+class OSCTrace : public Thread
+{
+public:
+
+	/** Producing threads, each writes to its own ring; listener thread i is LISTENER + i */
+	enum Source
+	{
+		AUDIO,
+		LISTENER
+	};
+
+	/** Constructor */
+	explicit OSCTrace(int numListeners);
+
+	/** Destructor -- flushes what is left */
+	~OSCTrace();
+
+	/** Adds a record, only ever called from the thread that owns source */
+	void record(int source, TraceEvent event,
+				int64 value0 = 0, int64 value1 = 0, int64 value2 = 0,
+				const char* text = nullptr, const char* detail = nullptr);
+
+	/** Thread loop */
+	void run() override;
+
+private:
+
+	/** Writes all pending records to the log, in time order */
+	void flush();
+
+	/** Formats a record as a log line */
+	String format(const TraceRecord& record, int source) const;
+
+	/** Indexed by source */
+	std::vector<std::unique_ptr<LockFreeQueue<TraceRecord>>> m_rings;
+
+	/** Flusher thread only */
+	std::vector<std::pair<TraceRecord, int>> m_pending;
+	std::vector<uint64> m_reportedDrops;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCTrace);
+};
+
+#endif
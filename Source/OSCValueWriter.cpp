@@ -0,0 +1,219 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OSCValueWriter.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_VALUE_WRITER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OSC_VALUE_WRITER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    /** Heap ordering: earliest sample first, then insertion order */
+    struct LaterPoint
+    {
+        bool operator()(const ValuePoint& a, const ValuePoint& b) const
+        {
+            if (a.sampleNumber != b.sampleNumber)
+                return a.sampleNumber > b.sampleNumber;
+
+            return int32_t(a.order - b.order) > 0;
+        }
+    };
+}
+
+OSCValueWriter::OSCValueWriter(int capacity)
+    : m_capacity(capacity)
+{
+    m_heap.reserve(capacity);
+}
+
+void OSCValueWriter::setNumChannels(int numChannels, int64_t maxRampSamples)
+{
+    m_channels.assign(numChannels, ChannelState());
+    m_written.assign(numChannels, 0);
+    m_maxRampSamples = maxRampSamples;
+
+    clear();
+}
+
+bool OSCValueWriter::schedule(int64_t sampleNumber, int channel, float value, bool interpolate)
+{
+    if (channel < 0 || channel >= getNumChannels() || getNumPending() >= m_capacity)
+    {
+        m_dropped++;
+        return false;
+    }
+
+    m_heap.push_back({ sampleNumber, m_nextOrder++, int16_t(channel), interpolate, value });
+    std::push_heap(m_heap.begin(), m_heap.end(), LaterPoint());
+
+    return true;
+}
+
+void OSCValueWriter::write(float* const* channels, int64_t startSampleNum, int numSamples)
+{
+    const int64_t endSampleNum = startSampleNum + numSamples;
+
+    std::fill(m_written.begin(), m_written.end(), startSampleNum);
+
+    // each channel is written up to its next update, which is then applied
+    while (!m_heap.empty() && m_heap.front().sampleNumber < endSampleNum)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), LaterPoint());
+        ValuePoint point = m_heap.back();
+        m_heap.pop_back();
+
+        const int channel = point.channel;
+
+        // late updates take effect at the first sample not yet written
+        point.sampleNumber = std::max(point.sampleNumber, m_written[channel]);
+
+        render(m_channels[channel], channels[channel], startSampleNum, m_written[channel], point.sampleNumber);
+        m_written[channel] = point.sampleNumber;
+
+        apply(m_channels[channel], point);
+    }
+
+    for (int channel = 0; channel < getNumChannels(); channel++)
+        render(m_channels[channel], channels[channel], startSampleNum, m_written[channel], endSampleNum);
+}
+
+void OSCValueWriter::render(ChannelState& state, float* block, int64_t blockStartSampleNum, int64_t from, int64_t to)
+{
+    while (from < to)
+    {
+        float* dest = block + (from - blockStartSampleNum);
+
+        if (state.slope == 0.0f)
+        {
+            fillHold(dest, state.value, int(to - from));
+            return;
+        }
+
+        const int numSamples = int(std::min(to, state.rampEndSample) - from);
+
+        fillRamp(dest, state.value, state.slope, numSamples);
+        state.value += state.slope * numSamples;
+        from += numSamples;
+
+        // the end of a ramp is exact, whatever the rounding on the way
+        if (from >= state.rampEndSample)
+        {
+            state.value = state.target;
+            state.slope = 0.0f;
+        }
+    }
+}
+
+void OSCValueWriter::apply(ChannelState& state, const ValuePoint& point)
+{
+    const int64_t interval = point.sampleNumber - state.lastUpdateSample;
+
+    state.lastUpdateSample = point.sampleNumber;
+
+    if (point.interpolate && interval > 0 && interval <= m_maxRampSamples && point.value != state.value)
+    {
+        state.slope = (point.value - state.value) / float(interval);
+        state.target = point.value;
+        state.rampEndSample = point.sampleNumber + interval;
+        return;
+    }
+
+    // after a gap (or for the first update) there is nothing to ramp from
+    state.value = point.value;
+    state.slope = 0.0f;
+}
+
+void OSCValueWriter::clear()
+{
+    m_heap.clear();
+    m_nextOrder = 0;
+    m_dropped = 0;
+
+    std::fill(m_channels.begin(), m_channels.end(), ChannelState());
+}
+
+void OSCValueWriter::fillHold(float* dest, float value, int numSamples)
+{
+    int i = 0;
+
+#if defined(OSC_VALUE_WRITER_SSE2)
+    const __m128 values = _mm_set1_ps(value);
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        _mm_storeu_ps(dest + i, values);
+        _mm_storeu_ps(dest + i + 4, values);
+    }
+#elif defined(OSC_VALUE_WRITER_NEON)
+    const float32x4_t values = vdupq_n_f32(value);
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        vst1q_f32(dest + i, values);
+        vst1q_f32(dest + i + 4, values);
+    }
+#endif
+
+    for (; i < numSamples; i++)
+        dest[i] = value;
+}
+
+void OSCValueWriter::fillRamp(float* dest, float start, float slope, int numSamples)
+{
+    int i = 0;
+
+    // every sample is computed from its index, so the error does not accumulate along the span
+#if defined(OSC_VALUE_WRITER_SSE2)
+    const __m128 starts = _mm_set1_ps(start);
+    const __m128 slopes = _mm_set1_ps(slope);
+    const __m128 four = _mm_set1_ps(4.0f);
+    __m128 indices = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        _mm_storeu_ps(dest + i, _mm_add_ps(starts, _mm_mul_ps(indices, slopes)));
+        indices = _mm_add_ps(indices, four);
+    }
+#elif defined(OSC_VALUE_WRITER_NEON)
+    const float32x4_t starts = vdupq_n_f32(start);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    const float indexValues[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    float32x4_t indices = vld1q_f32(indexValues);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        vst1q_f32(dest + i, vmlaq_n_f32(starts, indices, slope));
+        indices = vaddq_f32(indices, four);
+    }
+#endif
+
+    for (; i < numSamples; i++)
+        dest[i] = start + float(i) * slope;
+}
@@ -0,0 +1,117 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OSCVALUEWRITER_H
+#define OSCVALUEWRITER_H
+
+#include <cstdint>
+#include <vector>
+
+#define VALUE_WRITER_CAPACITY 4096
+
+/** One value update, due at a sample */
+struct ValuePoint
+{
+	int64_t sampleNumber;
+	uint32_t order;   // insertion order, keeps points on the same sample in FIFO order
+	int16_t channel;
+	bool interpolate;
+	float value;
+};
+
+/**
+	Writes OSC values into the continuous channels of one stream.
+
+	Each update takes effect at its sample. Between updates a channel
+	either holds the last value, or (for interpolated updates) ramps
+	linearly from its current value to the new one over the interval
+	since the channel's previous update, so a sender updating at a steady
+	rate produces a continuous line, one update period behind. Intervals
+	longer than maxRampSamples jump instead.
+
+	Pending updates are kept in a min-heap reserved in setNumChannels();
+	schedule() and write() never allocate. The spans between updates are
+	filled with SIMD (SSE2 or NEON) where available. Updates that do not
+	fit are dropped and counted.
+*/
+class OSCValueWriter
+{
+public:
+
+	/** Constructor */
+	explicit OSCValueWriter(int capacity = VALUE_WRITER_CAPACITY);
+
+	/** Sets the number of channels, which all restart at 0, and the longest ramp */
+	void setNumChannels(int numChannels, int64_t maxRampSamples);
+
+	/** Returns the number of channels */
+	int getNumChannels() const { return (int) m_channels.size(); }
+
+	/** Schedules an update, returns false if the writer is full or the channel does not exist */
+	bool schedule(int64_t sampleNumber, int channel, float value, bool interpolate);
+
+	/** Writes the block starting at startSampleNum into channels[0 .. getNumChannels()),
+		applying every update due before its end. Updates due earlier than a
+		channel's last written sample take effect at the start of the block */
+	void write(float* const* channels, int64_t startSampleNum, int numSamples);
+
+	/** Discards all pending updates, resets the channels to 0 and the drop counter */
+	void clear();
+
+	/** Returns the number of pending updates */
+	int getNumPending() const { return (int) m_heap.size(); }
+
+	/** Returns the number of updates dropped because the writer was full */
+	uint64_t getDroppedCount() const { return m_dropped; }
+
+	/** Span fills, exposed for benchmarking: dest[i] = value, and dest[i] = start + i * slope */
+	static void fillHold(float* dest, float value, int numSamples);
+	static void fillRamp(float* dest, float start, float slope, int numSamples);
+
+private:
+
+	/** Output state of one channel */
+	struct ChannelState
+	{
+		float value = 0.0f;      // at the next sample to be written
+		float slope = 0.0f;      // per sample, 0 while holding
+		float target = 0.0f;     // value at rampEndSample
+		int64_t rampEndSample = 0;
+		int64_t lastUpdateSample = -1;
+	};
+
+	/** Writes a channel's output from its state, for samples [from, to) of a block */
+	void render(ChannelState& state, float* block, int64_t blockStartSampleNum, int64_t from, int64_t to);
+
+	/** Applies an update to a channel's state */
+	void apply(ChannelState& state, const ValuePoint& point);
+
+	std::vector<ValuePoint> m_heap;
+	std::vector<ChannelState> m_channels;
+	std::vector<int64_t> m_written; // per channel, end of the samples written in the current block
+	int m_capacity;
+	int64_t m_maxRampSamples = 0;
+	uint32_t m_nextOrder = 0;
+	uint64_t m_dropped = 0;
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PacketSlabPool.h"
+
+#include <cstdint>
+#include <cstring>
+
+PacketSlabPool::PacketSlabPool(int numSlabs, int slabSize)
+    : m_numSlabs(numSlabs < 1 ? 1 : numSlabs),
+      m_slabSize((slabSize + PACKETSLABPOOL_ALIGNMENT - 1) / PACKETSLABPOOL_ALIGNMENT * PACKETSLABPOOL_ALIGNMENT),
+      m_references(new std::atomic<int>[m_numSlabs])
+{
+    // slabs start on cache lines, so views of neighbouring slabs never share one
+    m_storage.resize((std::size_t) m_numSlabs * m_slabSize + PACKETSLABPOOL_ALIGNMENT);
+
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+    m_data = m_storage.data() + (PACKETSLABPOOL_ALIGNMENT - address % PACKETSLABPOOL_ALIGNMENT) % PACKETSLABPOOL_ALIGNMENT;
+
+    for (int i = 0; i < m_numSlabs; i++)
+        m_references[i].store(0, std::memory_order_relaxed);
+}
+
+int PacketSlabPool::acquire(const char* data, int size)
+{
+    if (size > m_slabSize)
+        return -1;
+
+    // slabs are usually released in the order they were taken, so the search
+    // starting after the last slab taken ends on its first step
+    for (int n = 0; n < m_numSlabs; n++)
+    {
+        int slab = m_next + n < m_numSlabs ? m_next + n : m_next + n - m_numSlabs;
+
+        // acquire: the last holder's reads of the slab happen before it is overwritten
+        if (m_references[slab].load(std::memory_order_acquire) == 0)
+        {
+            m_references[slab].store(1, std::memory_order_relaxed);
+            m_next = slab + 1 < m_numSlabs ? slab + 1 : 0;
+
+            std::memcpy(m_data + (std::size_t) slab * m_slabSize, data, (std::size_t) size);
+            return slab;
+        }
+    }
+
+    return -1;
+}
+
+int PacketSlabPool::getNumInUse() const
+{
+    int inUse = 0;
+
+    for (int i = 0; i < m_numSlabs; i++)
+        if (m_references[i].load(std::memory_order_relaxed) > 0)
+            inUse++;
+
+    return inUse;
+}
@@ -0,0 +1,88 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PACKETSLABPOOL_H
+#define PACKETSLABPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#define PACKETSLABPOOL_ALIGNMENT 64
+
+/**
+	Fixed pool of equally sized slabs that datagrams are copied into, so the
+	messages parsed from them can be handed to another thread as views
+	(osc::ReceivedMessage) of slab memory instead of being copied apart.
+
+	A slab is reference counted. acquire() takes a free slab holding one
+	reference for its caller; every view handed on adds one, and whoever
+	drops the last reference returns the slab to the pool, from any thread.
+	Only one thread at a time may call acquire(). Nothing allocates or locks
+	after construction.
+*/
+class PacketSlabPool
+{
+public:
+
+	/** Constructor -- slabSize is rounded up to the alignment of the slabs */
+	PacketSlabPool(int numSlabs, int slabSize);
+
+	/** Takes a free slab and copies size bytes of data into it. Returns the
+		slab, holding one reference, or -1 if data is larger than a slab or
+		every slab is in use */
+	int acquire(const char* data, int size);
+
+	/** Start of a slab's memory */
+	const char* getData(int slab) const { return &m_data[(std::size_t) slab * m_slabSize]; }
+
+	/** Adds a reference to a slab the caller already holds one to */
+	void addReference(int slab) { m_references[slab].fetch_add(1, std::memory_order_relaxed); }
+
+	/** Drops a reference, the last one returns the slab to the pool */
+	void release(int slab) { m_references[slab].fetch_sub(1, std::memory_order_release); }
+
+	/** Number of slabs currently holding a datagram, approximate while in use */
+	int getNumInUse() const;
+
+	int getNumSlabs() const { return m_numSlabs; }
+	int getSlabSize() const { return m_slabSize; }
+
+private:
+
+	int m_numSlabs;
+	int m_slabSize;
+
+	/** acquire() only: where the search for a free slab starts */
+	int m_next = 0;
+
+	std::vector<char> m_storage;
+	char* m_data;
+
+	std::unique_ptr<std::atomic<int>[]> m_references;
+
+	PacketSlabPool(const PacketSlabPool&) = delete;
+	PacketSlabPool& operator=(const PacketSlabPool&) = delete;
+};
+
+#endif
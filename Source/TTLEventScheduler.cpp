@@ -0,0 +1,118 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TTLEventScheduler.h"
+
+#include <algorithm>
+
+namespace
+{
+    /** Heap ordering: earliest sample first, then insertion order */
+    struct LaterEdge
+    {
+        bool operator()(const TTLEdge& a, const TTLEdge& b) const
+        {
+            if (a.sampleNumber != b.sampleNumber)
+                return a.sampleNumber > b.sampleNumber;
+
+            return int32_t(a.order - b.order) > 0;
+        }
+    };
+}
+
+TTLEventScheduler::TTLEventScheduler(int capacity)
+    : m_capacity(capacity)
+{
+    m_heap.reserve(capacity);
+    clear();
+}
+
+void TTLEventScheduler::push(const TTLEdge& edge)
+{
+    m_heap.push_back(edge);
+    std::push_heap(m_heap.begin(), m_heap.end(), LaterEdge());
+}
+
+bool TTLEventScheduler::schedule(int64_t sampleNumber, int line, bool state)
+{
+    if (line < 0 || line >= TTL_SCHEDULER_MAX_LINES || getNumPending() >= m_capacity)
+    {
+        m_dropped++;
+        return false;
+    }
+
+    push({ sampleNumber, m_nextOrder++, int16_t(line), state, false });
+
+    return true;
+}
+
+bool TTLEventScheduler::schedulePulse(int64_t onSampleNumber, int64_t offSampleNumber, int line)
+{
+    if (line < 0 || line >= TTL_SCHEDULER_MAX_LINES || getNumPending() + 2 > m_capacity)
+    {
+        m_dropped += 2;
+        return false;
+    }
+
+    push({ onSampleNumber, m_nextOrder++, int16_t(line), true, true });
+    push({ offSampleNumber, m_nextOrder++, int16_t(line), false, true });
+
+    return true;
+}
+
+bool TTLEventScheduler::popEdgeBefore(int64_t endSampleNumber, TTLEdge& edge)
+{
+    while (!m_heap.empty() && m_heap.front().sampleNumber < endSampleNumber)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), LaterEdge());
+        edge = m_heap.back();
+        m_heap.pop_back();
+
+        if (edge.pulse)
+        {
+            int32_t& active = m_activePulses[edge.line];
+
+            if (edge.state)
+            {
+                active++;
+            }
+            else if (active > 0 && --active > 0)
+            {
+                // another pulse on the same line is still running
+                continue;
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void TTLEventScheduler::clear()
+{
+    m_heap.clear();
+    m_nextOrder = 0;
+    m_dropped = 0;
+
+    std::fill(m_activePulses, m_activePulses + TTL_SCHEDULER_MAX_LINES, 0);
+}
@@ -0,0 +1,94 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TTLEVENTSCHEDULER_H
+#define TTLEVENTSCHEDULER_H
+
+#include <cstdint>
+#include <vector>
+
+#define TTL_SCHEDULER_CAPACITY 1024
+#define TTL_SCHEDULER_MAX_LINES 256
+
+/** One scheduled TTL transition */
+struct TTLEdge
+{
+	int64_t sampleNumber;
+	uint32_t order;   // insertion order, keeps edges on the same sample in FIFO order
+	int16_t line;
+	bool state;
+	bool pulse;       // edge of a pulse: its turn-off edge is suppressed while another pulse on the line is active
+};
+
+/**
+	Min-heap of future TTL edges for one stream, keyed by sample number.
+
+	Any number of pulses may overlap, on the same or on different lines.
+	When pulses overlap on one line, the line stays high until the last of
+	them ends: each line counts its active pulses as their edges are popped,
+	and a pulse end is only emitted once no other pulse is active, so it
+	never cuts a later pulse short, whatever order the pulses were
+	scheduled in.
+
+	Storage is reserved in the constructor; schedule() and popEdgeBefore()
+	never allocate and run in O(log n). Edges that do not fit are dropped
+	and counted.
+*/
+class TTLEventScheduler
+{
+public:
+
+	/** Constructor */
+	explicit TTLEventScheduler(int capacity = TTL_SCHEDULER_CAPACITY);
+
+	/** Schedules a single transition, returns false if the scheduler is full */
+	bool schedule(int64_t sampleNumber, int line, bool state);
+
+	/** Schedules a pulse (on edge and its turn-off edge), returns false if the scheduler is full */
+	bool schedulePulse(int64_t onSampleNumber, int64_t offSampleNumber, int line);
+
+	/** Removes the earliest edge occurring before endSampleNumber, returns false if there is none */
+	bool popEdgeBefore(int64_t endSampleNumber, TTLEdge& edge);
+
+	/** Discards all pending edges and resets the drop counter */
+	void clear();
+
+	/** Returns the number of pending edges */
+	int getNumPending() const { return (int) m_heap.size(); }
+
+	/** Returns the number of edges dropped because the scheduler was full */
+	uint64_t getDroppedCount() const { return m_dropped; }
+
+private:
+
+	void push(const TTLEdge& edge);
+
+	std::vector<TTLEdge> m_heap;
+	int m_capacity;
+	uint32_t m_nextOrder = 0;
+	uint64_t m_dropped = 0;
+
+	// pulses on each line whose on edge has been popped but not their off edge
+	int32_t m_activePulses[TTL_SCHEDULER_MAX_LINES];
+};
+
+#endif
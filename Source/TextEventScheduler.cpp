@@ -0,0 +1,90 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TextEventScheduler.h"
+
+#include <algorithm>
+
+namespace
+{
+    /** Heap ordering: earliest sample first, then insertion order */
+    struct LaterEvent
+    {
+        bool operator()(const PendingTextEvent& a, const PendingTextEvent& b) const
+        {
+            if (a.sampleNumber != b.sampleNumber)
+                return a.sampleNumber > b.sampleNumber;
+
+            return int32_t(a.order - b.order) > 0;
+        }
+    };
+}
+
+TextEventScheduler::TextEventScheduler(int capacity)
+    : m_capacity(capacity)
+{
+    m_heap.reserve(capacity);
+}
+
+bool TextEventScheduler::schedule(int64_t sampleNumber, int label, const double* values, int numValues)
+{
+    if (getNumPending() >= m_capacity)
+    {
+        m_dropped++;
+        return false;
+    }
+
+    PendingTextEvent event;
+
+    event.sampleNumber = sampleNumber;
+    event.order = m_nextOrder++;
+    event.label = label;
+    event.numValues = std::min(numValues, TEXT_EVENT_MAX_VALUES);
+
+    // unused values are 0, so every event carries the same metadata
+    std::fill(event.values, event.values + TEXT_EVENT_MAX_VALUES, 0.0);
+    std::copy(values, values + event.numValues, event.values);
+
+    m_heap.push_back(event);
+    std::push_heap(m_heap.begin(), m_heap.end(), LaterEvent());
+
+    return true;
+}
+
+bool TextEventScheduler::popEventBefore(int64_t endSampleNumber, PendingTextEvent& event)
+{
+    if (m_heap.empty() || m_heap.front().sampleNumber >= endSampleNumber)
+        return false;
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), LaterEvent());
+    event = m_heap.back();
+    m_heap.pop_back();
+
+    return true;
+}
+
+void TextEventScheduler::clear()
+{
+    m_heap.clear();
+    m_nextOrder = 0;
+    m_dropped = 0;
+}
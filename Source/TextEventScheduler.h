@@ -0,0 +1,81 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEXTEVENTSCHEDULER_H
+#define TEXTEVENTSCHEDULER_H
+
+#include <cstdint>
+#include <vector>
+
+#define TEXT_SCHEDULER_CAPACITY 1024
+#define TEXT_EVENT_MAX_VALUES 8
+
+/** One scheduled text event: an interned label and the numeric arguments of its message */
+struct PendingTextEvent
+{
+	int64_t sampleNumber;
+	uint32_t order;   // insertion order, keeps events on the same sample in FIFO order
+	int label;        // OSCLabelTable id
+	int numValues;
+	double values[TEXT_EVENT_MAX_VALUES];
+};
+
+/**
+	Min-heap of future text events for one stream, keyed by sample number,
+	so time-tagged text events wait for the block they fall into like TTL
+	edges do (see TTLEventScheduler).
+
+	Storage is reserved in the constructor; schedule() and popEventBefore()
+	never allocate. Events that do not fit are dropped and counted.
+*/
+class TextEventScheduler
+{
+public:
+
+	/** Constructor */
+	explicit TextEventScheduler(int capacity = TEXT_SCHEDULER_CAPACITY);
+
+	/** Schedules an event with up to TEXT_EVENT_MAX_VALUES values (more are ignored),
+		returns false if the scheduler is full */
+	bool schedule(int64_t sampleNumber, int label, const double* values, int numValues);
+
+	/** Removes the earliest event occurring before endSampleNumber, returns false if there is none */
+	bool popEventBefore(int64_t endSampleNumber, PendingTextEvent& event);
+
+	/** Discards all pending events and resets the drop counter */
+	void clear();
+
+	/** Returns the number of pending events */
+	int getNumPending() const { return (int) m_heap.size(); }
+
+	/** Returns the number of events dropped because the scheduler was full */
+	uint64_t getDroppedCount() const { return m_dropped; }
+
+private:
+
+	std::vector<PendingTextEvent> m_heap;
+	int m_capacity;
+	uint32_t m_nextOrder = 0;
+	uint64_t m_dropped = 0;
+};
+
+#endif
@@ -45,6 +45,26 @@ public:
     virtual ~PacketListener() {}
     virtual void ProcessPacket( const char *data, int size, 
 			const IpEndpointName& remoteEndpoint ) = 0;
+
+    // Called by SocketReceiveMultiplexer with the datagram's arrival time
+    // (nanoseconds, see GetPacketClockNanoseconds()). Uses the kernel receive
+    // time stamp where available. The default implementation discards it.
+    virtual void ProcessTimestampedPacket( const char *data, int size,
+			const IpEndpointName& remoteEndpoint, unsigned long long arrivalTimeNs )
+    {
+        (void) arrivalTimeNs;
+        ProcessPacket( data, size, remoteEndpoint );
+    }
+
+    // Called by SocketReceiveMultiplexer instead of ProcessPacket() for a
+    // datagram larger than its receive buffer (see
+    // SocketReceiveMultiplexer::SetMaxDatagramSize()); the datagram is
+    // dropped. The default implementation ignores it.
+    virtual void ProcessTruncatedPacket( int bufferSize, const IpEndpointName& remoteEndpoint )
+    {
+        (void) bufferSize; // suppress unused parameter warnings
+        (void) remoteEndpoint;
+    }
 };
 
 #endif /* INCLUDED_OSCPACK_PACKETLISTENER_H */
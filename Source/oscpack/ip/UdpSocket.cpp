@@ -40,7 +40,7 @@
 
 #include <winsock2.h>   // this must come first to prevent errors with MSVC7
 #include <windows.h>
-#include <mmsystem.h>   // for timeGetTime()
+#include <math.h>
 
 #ifndef WINCE
 #include <signal.h>
@@ -57,15 +57,27 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netinet/in.h> // for sockaddr_in
+#include <sys/uio.h> // for iovec
 
 #include <signal.h>
 #include <math.h>
 #include <errno.h>
 #include <string.h>
 
+#if defined(__linux__)
+#define OSC_HAVE_RECVMMSG // recvmmsg() is available since Linux 2.6.33 / glibc 2.12
+#ifndef OSC_DISABLE_EPOLL
+#define OSC_HAVE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+#endif
+
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring> // for memset
 #include <stdexcept>
@@ -115,6 +127,37 @@ static IpEndpointName IpEndpointNameFromSockaddr( const struct sockaddr_in& sock
 }
 
 
+unsigned long long GetPacketClockNanoseconds()
+{
+    // 100ns intervals since 1601-01-01, rebased to the unix epoch
+    FILETIME fileTime;
+    GetSystemTimePreciseAsFileTime( &fileTime );
+
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = fileTime.dwLowDateTime;
+    ticks.HighPart = fileTime.dwHighDateTime;
+
+    return (ticks.QuadPart - 116444736000000000ULL) * 100;
+}
+
+
+unsigned long long GetMonotonicClockNanoseconds()
+{
+    static LARGE_INTEGER frequency = { 0 };
+    if( frequency.QuadPart == 0 )
+        QueryPerformanceFrequency( &frequency );
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter( &counter );
+
+    // split to avoid overflowing the multiplication
+    unsigned long long ticks = (unsigned long long)counter.QuadPart;
+    unsigned long long ticksPerSecond = (unsigned long long)frequency.QuadPart;
+
+    return (ticks / ticksPerSecond) * 1000000000ULL + ((ticks % ticksPerSecond) * 1000000000ULL) / ticksPerSecond;
+}
+
+
 class UdpSocket::Implementation{
     NetworkInitializer networkInitializer_;
 
@@ -161,6 +204,13 @@ public:
         setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr));
     }
 
+    bool SetEnableReusePort( bool enableReusePort )
+    {
+        // SO_REUSEADDR shares a port on Win32, but does not balance datagrams
+        (void) enableReusePort;
+        return false;
+    }
+
     IpEndpointName LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
     {
         assert( isBound_ );
@@ -263,6 +313,33 @@ public:
         return result;
     }
 
+    // as ReceiveFrom(), also reporting datagrams that did not fit in size
+    // bytes, of which only the first size bytes are received
+    std::size_t ReceiveFrom( IpEndpointName& remoteEndpoint, char *data, std::size_t size, bool& truncated )
+    {
+        assert( isBound_ );
+
+        struct sockaddr_in fromAddr;
+        socklen_t fromAddrLen = sizeof(fromAddr);
+
+        truncated = false;
+
+        int result = recvfrom(socket_, data, (int)size, 0,
+                    (struct sockaddr *) &fromAddr, (socklen_t*)&fromAddrLen);
+        if( result == SOCKET_ERROR ){
+            if( WSAGetLastError() != WSAEMSGSIZE )
+                return 0;
+
+            truncated = true;
+            result = (int)size;
+        }
+
+        remoteEndpoint.address = ntohl(fromAddr.sin_addr.s_addr);
+        remoteEndpoint.port = ntohs(fromAddr.sin_port);
+
+        return result;
+    }
+
     SOCKET& Socket() { return socket_; }
 };
 
@@ -286,6 +363,16 @@ void UdpSocket::SetAllowReuse( bool allowReuse )
     impl_->SetAllowReuse( allowReuse );
 }
 
+bool UdpSocket::SetEnableReusePort( bool enableReusePort )
+{
+    return impl_->SetEnableReusePort( enableReusePort );
+}
+
+bool UdpSocket::IsReusePortSupported()
+{
+    return false;
+}
+
 IpEndpointName UdpSocket::LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 {
     return impl_->LocalEndpointFor( remoteEndpoint );
@@ -333,10 +420,13 @@ struct AttachedTimerListener{
 };
 
 
-static bool CompareScheduledTimerCalls(
-        const std::pair< double, AttachedTimerListener > & lhs, const std::pair< double, AttachedTimerListener > & rhs )
+// expiry time (GetMonotonicClockNanoseconds()), listener
+typedef std::pair< unsigned long long, AttachedTimerListener > ScheduledTimerCall;
+
+// orders the timer queue as a min-heap: the next timer to expire is at the front
+static bool CompareScheduledTimerCalls( const ScheduledTimerCall& lhs, const ScheduledTimerCall& rhs )
 {
-    return lhs.first < rhs.first;
+    return lhs.first > rhs.first;
 }
 
 
@@ -361,17 +451,91 @@ class SocketReceiveMultiplexer::Implementation{
     volatile bool break_;
     HANDLE breakEvent_;
 
-    double GetCurrentTimeMs() const
+    // batched receive: up to batchSize_ datagrams are drained per wakeup
+    int batchSize_;
+
+    // receive buffer, kept across Run() calls
+    int maxDatagramSize_;
+    std::vector<char> data_;
+
+    std::atomic<unsigned long long> batchCount_;
+    std::atomic<unsigned long long> datagramCount_;
+    std::atomic<unsigned long long> truncatedCount_;
+    std::atomic<unsigned int> lastBatchSize_;
+    std::atomic<unsigned int> maxBatchSize_;
+
+    void RecordBatch( unsigned int size )
     {
-#ifndef WINCE
-        return timeGetTime(); // FIXME: bad choice if you want to run for more than 40 days
-#else
-        return 0;
-#endif
+        batchCount_.fetch_add( 1, std::memory_order_relaxed );
+        datagramCount_.fetch_add( size, std::memory_order_relaxed );
+        lastBatchSize_.store( size, std::memory_order_relaxed );
+        if( size > maxBatchSize_.load( std::memory_order_relaxed ) )
+            maxBatchSize_.store( size, std::memory_order_relaxed );
+    }
+
+    typedef std::vector< ScheduledTimerCall > TimerQueue;
+
+    void InitializeTimerQueue( TimerQueue& timerQueue ) const
+    {
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+
+        for( std::vector< AttachedTimerListener >::const_iterator i = timerListeners_.begin();
+                i != timerListeners_.end(); ++i )
+            timerQueue.push_back( std::make_pair( currentTimeNs + (unsigned long long)i->initialDelayMs * 1000000ULL, *i ) );
+        std::make_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+    }
+
+    // milliseconds until the next timer expires, or -1 if there are no timers
+    double TimeUntilNextTimerMs( const TimerQueue& timerQueue ) const
+    {
+        if( timerQueue.empty() )
+            return -1;
+
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+        if( timerQueue.front().first <= currentTimeNs )
+            return 0;
+
+        return (double)(timerQueue.front().first - currentTimeNs) * 1e-6;
+    }
+
+    // O(log n) per expired timer: only the expired timers leave and re-enter the heap
+    void ExecuteExpiredTimers( TimerQueue& timerQueue )
+    {
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+
+        // each timer fires at most once per call, even with a zero period
+        for( std::size_t n = timerQueue.size();
+                n > 0 && timerQueue.front().first <= currentTimeNs; --n ){
+
+            std::pop_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+            ScheduledTimerCall& timer = timerQueue.back();
+            TimerListener *listener = timer.second.listener;
+
+            // periods missed while the thread was busy are skipped rather than
+            // fired in a burst: the timer stays on its schedule, at most one
+            // period overdue
+            unsigned long long periodNs = (unsigned long long)timer.second.periodMs * 1000000ULL;
+            timer.first += periodNs;
+            if( periodNs > 0 && timer.first + periodNs <= currentTimeNs )
+                timer.first += ((currentTimeNs - timer.first) / periodNs) * periodNs;
+            std::push_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+
+            listener->TimerExpired();
+            if( break_ )
+                break;
+        }
     }
 
 public:
     Implementation()
+        : batchSize_( 1 )
+        , maxDatagramSize_( SocketReceiveMultiplexer::DEFAULT_MAX_DATAGRAM_SIZE )
+        , data_( SocketReceiveMultiplexer::DEFAULT_MAX_DATAGRAM_SIZE )
+        , batchCount_( 0 )
+        , datagramCount_( 0 )
+        , truncatedCount_( 0 )
+        , lastBatchSize_( 0 )
+        , maxBatchSize_( 0 )
     {
         breakEvent_ = CreateEvent( NULL, FALSE, FALSE, NULL );
     }
@@ -421,6 +585,39 @@ public:
         timerListeners_.erase( i );
     }
 
+    void SetBackend( SocketReceiveMultiplexer::Backend backend )
+    {
+        (void) backend; // Windows always uses WaitForMultipleObjects()
+    }
+
+    SocketReceiveMultiplexer::Backend GetBackend() const { return SocketReceiveMultiplexer::SELECT_BACKEND; }
+
+    void SetReceiveBatchSize( int maxDatagrams )
+    {
+        batchSize_ = (maxDatagrams < 1) ? 1 : maxDatagrams;
+    }
+
+    void SetMaxDatagramSize( int bytes )
+    {
+        maxDatagramSize_ = (bytes < 1) ? 1
+                : (bytes > SocketReceiveMultiplexer::MAX_DATAGRAM_SIZE) ? SocketReceiveMultiplexer::MAX_DATAGRAM_SIZE : bytes;
+
+        data_.assign( maxDatagramSize_, 0 );
+    }
+
+    int GetMaxDatagramSize() const { return maxDatagramSize_; }
+
+    SocketReceiveMultiplexer::ReceiveStatistics GetReceiveStatistics() const
+    {
+        SocketReceiveMultiplexer::ReceiveStatistics result;
+        result.batchCount = batchCount_.load( std::memory_order_relaxed );
+        result.datagramCount = datagramCount_.load( std::memory_order_relaxed );
+        result.truncatedCount = truncatedCount_.load( std::memory_order_relaxed );
+        result.lastBatchSize = lastBatchSize_.load( std::memory_order_relaxed );
+        result.maxBatchSize = maxBatchSize_.load( std::memory_order_relaxed );
+        return result;
+    }
+
     void Run()
     {
         break_ = false;
@@ -441,31 +638,18 @@ public:
 
         events[ socketListeners_.size() ] = breakEvent_; // last event in the collection is the break event
 
-        // configure the timer queue
-        double currentTimeMs = GetCurrentTimeMs();
+        TimerQueue timerQueue_;
+        InitializeTimerQueue( timerQueue_ );
 
-        // expiry time ms, listener
-        std::vector< std::pair< double, AttachedTimerListener > > timerQueue_;
-        for( std::vector< AttachedTimerListener >::iterator i = timerListeners_.begin();
-                i != timerListeners_.end(); ++i )
-            timerQueue_.push_back( std::make_pair( currentTimeMs + i->initialDelayMs, *i ) );
-        std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
-
-        const int MAX_BUFFER_SIZE = 4098;
-        char *data = new char[ MAX_BUFFER_SIZE ];
+        char *data = &data_[0];
         IpEndpointName remoteEndpoint;
 
         while( !break_ ){
 
-            double currentTimeMs = GetCurrentTimeMs();
-
             DWORD waitTime = INFINITE;
-            if( !timerQueue_.empty() ){
-
-                waitTime = (DWORD)( timerQueue_.front().first >= currentTimeMs
-                            ? timerQueue_.front().first - currentTimeMs
-                            : 0 );
-            }
+            double timeoutMs = TimeUntilNextTimerMs( timerQueue_ );
+            if( timeoutMs >= 0 )
+                waitTime = (DWORD)ceil( timeoutMs );
 
             DWORD waitResult = WaitForMultipleObjects( (DWORD)socketListeners_.size() + 1, &events[0], FALSE, waitTime );
             if( break_ )
@@ -473,33 +657,36 @@ public:
 
             if( waitResult != WAIT_TIMEOUT ){
                 for( int i = waitResult - WAIT_OBJECT_0; i < (int)socketListeners_.size(); ++i ){
-                    std::size_t size = socketListeners_[i].second->ReceiveFrom( remoteEndpoint, data, MAX_BUFFER_SIZE );
-                    if( size > 0 ){
-                        socketListeners_[i].first->ProcessPacket( data, (int)size, remoteEndpoint );
+                    // the sockets are non-blocking, so drain up to batchSize_ datagrams
+                    unsigned int count = 0;
+                    for( int j = 0; j < batchSize_; ++j ){
+                        bool truncated;
+                        std::size_t size = socketListeners_[i].second->impl_->ReceiveFrom( remoteEndpoint, data,
+                                (std::size_t)maxDatagramSize_, truncated );
+                        if( size == 0 )
+                            break;
+
+                        ++count;
+                        if( truncated ){
+                            truncatedCount_.fetch_add( 1, std::memory_order_relaxed );
+                            socketListeners_[i].first->ProcessTruncatedPacket( maxDatagramSize_, remoteEndpoint );
+                        }else{
+                            socketListeners_[i].first->ProcessTimestampedPacket( data, (int)size, remoteEndpoint,
+                                    GetPacketClockNanoseconds() );
+                        }
                         if( break_ )
                             break;
                     }
+                    if( count > 0 )
+                        RecordBatch( count );
+                    if( break_ )
+                        break;
                 }
             }
             // execute any expired timers
-            currentTimeMs = GetCurrentTimeMs();
-            bool resort = false;
-            for( std::vector< std::pair< double, AttachedTimerListener > >::iterator i = timerQueue_.begin();
-                    i != timerQueue_.end() && i->first <= currentTimeMs; ++i ){
-
-                i->second.listener->TimerExpired();
-                if( break_ )
-                    break;
-
-                i->first += i->second.periodMs;
-                resort = true;
-            }
-            if( resort )
-                std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
+            ExecuteExpiredTimers( timerQueue_ );
         }
 
-        delete [] data;
-
         // free events
         j = 0;
         for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
@@ -561,6 +748,36 @@ void SocketReceiveMultiplexer::DetachPeriodicTimerListener( TimerListener *liste
     impl_->DetachPeriodicTimerListener( listener );
 }
 
+void SocketReceiveMultiplexer::SetBackend( Backend backend )
+{
+    impl_->SetBackend( backend );
+}
+
+SocketReceiveMultiplexer::Backend SocketReceiveMultiplexer::GetBackend() const
+{
+    return impl_->GetBackend();
+}
+
+void SocketReceiveMultiplexer::SetReceiveBatchSize( int maxDatagrams )
+{
+    impl_->SetReceiveBatchSize( maxDatagrams );
+}
+
+void SocketReceiveMultiplexer::SetMaxDatagramSize( int bytes )
+{
+    impl_->SetMaxDatagramSize( bytes );
+}
+
+int SocketReceiveMultiplexer::GetMaxDatagramSize() const
+{
+    return impl_->GetMaxDatagramSize();
+}
+
+SocketReceiveMultiplexer::ReceiveStatistics SocketReceiveMultiplexer::GetReceiveStatistics() const
+{
+    return impl_->GetReceiveStatistics();
+}
+
 void SocketReceiveMultiplexer::Run()
 {
     impl_->Run();
@@ -630,6 +847,48 @@ static IpEndpointName IpEndpointNameFromSockaddr( const struct sockaddr_in& sock
 }
 
 
+unsigned long long GetPacketClockNanoseconds()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_REALTIME, &now );
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+
+unsigned long long GetMonotonicClockNanoseconds()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+
+#ifdef SO_TIMESTAMPNS
+// room for the SCM_TIMESTAMPNS control message attached to each datagram
+static const std::size_t TIMESTAMP_CONTROL_SIZE = CMSG_SPACE( sizeof(struct timespec) );
+#endif
+
+// returns the kernel receive time stamp of a datagram received with recvmsg(),
+// or the current time if the kernel didn't supply one
+static unsigned long long ArrivalTimeFromMessageHeader( struct msghdr& header )
+{
+#ifdef SO_TIMESTAMPNS
+    for( struct cmsghdr *c = CMSG_FIRSTHDR( &header ); c != 0; c = CMSG_NXTHDR( &header, c ) ){
+        if( c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS ){
+            struct timespec arrival;
+            std::memcpy( &arrival, CMSG_DATA( c ), sizeof(arrival) );
+            return (unsigned long long)arrival.tv_sec * 1000000000ULL + (unsigned long long)arrival.tv_nsec;
+        }
+    }
+#else
+    (void) header;
+#endif
+    return GetPacketClockNanoseconds();
+}
+
+
 class UdpSocket::Implementation{
     bool isBound_;
     bool isConnected_;
@@ -676,6 +935,18 @@ public:
 #endif
     }
 
+    bool SetEnableReusePort( bool enableReusePort )
+    {
+#if defined(__linux__) && defined(SO_REUSEPORT)
+        int reusePort = (enableReusePort) ? 1 : 0; // int on posix
+        return setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) == 0;
+#else
+        // BSD and OS X deliver unicast datagrams to one of the sockets only
+        (void) enableReusePort;
+        return false;
+#endif
+    }
+
     IpEndpointName LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
     {
         assert( isBound_ );
@@ -756,19 +1027,25 @@ public:
             throw std::runtime_error("unable to bind udp socket\n");
         }
 
+#ifdef SO_TIMESTAMPNS
+        // ask the kernel to stamp every datagram with its arrival time
+        int enableTimestamps = 1;
+        setsockopt(socket_, SOL_SOCKET, SO_TIMESTAMPNS, &enableTimestamps, sizeof(enableTimestamps));
+#endif
+
         isBound_ = true;
     }
 
     bool IsBound() const { return isBound_; }
 
-    std::size_t ReceiveFrom( IpEndpointName& remoteEndpoint, char *data, std::size_t size )
+    std::size_t ReceiveFrom( IpEndpointName& remoteEndpoint, char *data, std::size_t size, int flags=0 )
     {
         assert( isBound_ );
 
         struct sockaddr_in fromAddr;
         socklen_t fromAddrLen = sizeof(fromAddr);
 
-        ssize_t result = recvfrom(socket_, data, size, 0,
+        ssize_t result = recvfrom(socket_, data, size, flags,
                     (struct sockaddr *) &fromAddr, (socklen_t*)&fromAddrLen);
         if( result < 0 )
             return 0;
@@ -779,6 +1056,60 @@ public:
         return (std::size_t)result;
     }
 
+    // as ReceiveFrom(), also returning the datagram's arrival time on the packet clock
+    // datagrams that did not fit in size bytes are reported through truncated
+    std::size_t ReceiveFrom( IpEndpointName& remoteEndpoint, char *data, std::size_t size, int flags,
+            unsigned long long& arrivalTimeNs, bool& truncated )
+    {
+        assert( isBound_ );
+
+        struct sockaddr_in fromAddr;
+        struct iovec iov;
+        iov.iov_base = data;
+        iov.iov_len = size;
+
+#ifdef SO_TIMESTAMPNS
+        char control[ TIMESTAMP_CONTROL_SIZE ];
+#endif
+
+        struct msghdr header;
+        std::memset( &header, 0, sizeof(header) );
+        header.msg_name = &fromAddr;
+        header.msg_namelen = sizeof(fromAddr);
+        header.msg_iov = &iov;
+        header.msg_iovlen = 1;
+#ifdef SO_TIMESTAMPNS
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+#endif
+
+        ssize_t result = recvmsg(socket_, &header, flags);
+        if( result < 0 )
+            return 0;
+
+        arrivalTimeNs = ArrivalTimeFromMessageHeader( header );
+        truncated = (header.msg_flags & MSG_TRUNC) != 0;
+
+        remoteEndpoint.address = ntohl(fromAddr.sin_addr.s_addr);
+        remoteEndpoint.port = ntohs(fromAddr.sin_port);
+
+        return (std::size_t)result;
+    }
+
+#ifdef OSC_HAVE_RECVMMSG
+    // receive up to count datagrams without blocking, returns the number received
+    int ReceiveBatch( struct mmsghdr *messages, unsigned int count )
+    {
+        assert( isBound_ );
+
+        int result = recvmmsg( socket_, messages, count, MSG_DONTWAIT, 0 );
+        if( result < 0 )
+            return 0;
+
+        return result;
+    }
+#endif
+
     int Socket() { return socket_; }
 };
 
@@ -802,6 +1133,20 @@ void UdpSocket::SetAllowReuse( bool allowReuse )
     impl_->SetAllowReuse( allowReuse );
 }
 
+bool UdpSocket::SetEnableReusePort( bool enableReusePort )
+{
+    return impl_->SetEnableReusePort( enableReusePort );
+}
+
+bool UdpSocket::IsReusePortSupported()
+{
+#if defined(__linux__) && defined(SO_REUSEPORT)
+    return true;
+#else
+    return false;
+#endif
+}
+
 IpEndpointName UdpSocket::LocalEndpointFor( const IpEndpointName& remoteEndpoint ) const
 {
     return impl_->LocalEndpointFor( remoteEndpoint );
@@ -849,10 +1194,13 @@ struct AttachedTimerListener{
 };
 
 
-static bool CompareScheduledTimerCalls(
-        const std::pair< double, AttachedTimerListener > & lhs, const std::pair< double, AttachedTimerListener > & rhs )
+// expiry time (GetMonotonicClockNanoseconds()), listener
+typedef std::pair< unsigned long long, AttachedTimerListener > ScheduledTimerCall;
+
+// orders the timer queue as a min-heap: the next timer to expire is at the front
+static bool CompareScheduledTimerCalls( const ScheduledTimerCall& lhs, const ScheduledTimerCall& rhs )
 {
-    return lhs.first < rhs.first;
+    return lhs.first > rhs.first;
 }
 
 
@@ -871,28 +1219,479 @@ class SocketReceiveMultiplexer::Implementation{
     std::vector< AttachedTimerListener > timerListeners_;
 
     volatile bool break_;
+#ifdef OSC_HAVE_EPOLL
+    int breakEvent_; // eventfd used to wake Run() from AsynchronousBreak()
+#else
     int breakPipe_[2]; // [0] is the reader descriptor and [1] the writer
+#endif
+
+    SocketReceiveMultiplexer::Backend backend_;
+
+    // batched receive: up to batchSize_ datagrams are drained per wakeup
+    int batchSize_;
+
+    // receive buffers, kept across Run() calls
+    int maxDatagramSize_;
+    std::vector<char> data_;
+#ifdef OSC_HAVE_RECVMMSG
+    std::vector<char> batchData_; // batchSize_ * maxDatagramSize_ bytes
+    std::vector<struct mmsghdr> batchHeaders_;
+    std::vector<struct iovec> batchIovecs_;
+    std::vector<struct sockaddr_in> batchAddresses_;
+#ifdef SO_TIMESTAMPNS
+    std::vector<char> batchControl_; // batchSize_ * TIMESTAMP_CONTROL_SIZE bytes
+#endif
+#endif
+
+    std::atomic<unsigned long long> batchCount_;
+    std::atomic<unsigned long long> datagramCount_;
+    std::atomic<unsigned long long> truncatedCount_;
+    std::atomic<unsigned int> lastBatchSize_;
+    std::atomic<unsigned int> maxBatchSize_;
+
+    void RecordBatch( unsigned int size )
+    {
+        batchCount_.fetch_add( 1, std::memory_order_relaxed );
+        datagramCount_.fetch_add( size, std::memory_order_relaxed );
+        lastBatchSize_.store( size, std::memory_order_relaxed );
+        if( size > maxBatchSize_.load( std::memory_order_relaxed ) )
+            maxBatchSize_.store( size, std::memory_order_relaxed );
+    }
 
-    double GetCurrentTimeMs() const
+    void AllocateReceiveBuffers()
     {
-        struct timeval t;
+        data_.assign( maxDatagramSize_, 0 );
 
-        gettimeofday( &t, 0 );
+#ifdef OSC_HAVE_RECVMMSG
+        // the batch slab is only used with batches of more than one datagram
+        if( batchSize_ == 1 ){
+            batchData_.clear();
+            return;
+        }
+
+        batchData_.assign( (std::size_t)batchSize_ * maxDatagramSize_, 0 );
+        batchHeaders_.assign( batchSize_, mmsghdr() );
+        batchIovecs_.assign( batchSize_, iovec() );
+        batchAddresses_.assign( batchSize_, sockaddr_in() );
+#ifdef SO_TIMESTAMPNS
+        batchControl_.assign( (std::size_t)batchSize_ * TIMESTAMP_CONTROL_SIZE, 0 );
+#endif
 
-        return ((double)t.tv_sec*1000.) + ((double)t.tv_usec / 1000.);
+        for( int j=0; j < batchSize_; ++j ){
+            batchIovecs_[j].iov_base = &batchData_[ (std::size_t)j * maxDatagramSize_ ];
+            batchIovecs_[j].iov_len = maxDatagramSize_;
+
+            std::memset( &batchHeaders_[j], 0, sizeof(mmsghdr) );
+            batchHeaders_[j].msg_hdr.msg_name = &batchAddresses_[j];
+            batchHeaders_[j].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            batchHeaders_[j].msg_hdr.msg_iov = &batchIovecs_[j];
+            batchHeaders_[j].msg_hdr.msg_iovlen = 1;
+#ifdef SO_TIMESTAMPNS
+            batchHeaders_[j].msg_hdr.msg_control = &batchControl_[ j * TIMESTAMP_CONTROL_SIZE ];
+            batchHeaders_[j].msg_hdr.msg_controllen = TIMESTAMP_CONTROL_SIZE;
+#endif
+        }
+#endif
     }
 
+    // drain up to batchSize_ datagrams from a readable socket, delivering them in order.
+    // returns the number of datagrams received
+    unsigned int ReceiveDatagrams( PacketListener *listener, UdpSocket *socket, char *data, bool nonBlocking )
+    {
+        IpEndpointName remoteEndpoint;
+
+#ifdef OSC_HAVE_RECVMMSG
+        if( batchSize_ > 1 ){
+            for( int j=0; j < batchSize_; ++j ){
+                batchHeaders_[j].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+#ifdef SO_TIMESTAMPNS
+                batchHeaders_[j].msg_hdr.msg_controllen = TIMESTAMP_CONTROL_SIZE;
+#endif
+                batchHeaders_[j].msg_hdr.msg_flags = 0;
+                batchHeaders_[j].msg_len = 0;
+            }
+
+            int count = socket->impl_->ReceiveBatch( &batchHeaders_[0], (unsigned int)batchSize_ );
+            if( count > 0 )
+                RecordBatch( (unsigned int)count );
+
+            for( int j=0; j < count; ++j ){
+                if( batchHeaders_[j].msg_len == 0 )
+                    continue;
+
+                remoteEndpoint.address = ntohl( batchAddresses_[j].sin_addr.s_addr );
+                remoteEndpoint.port = ntohs( batchAddresses_[j].sin_port );
+
+                if( batchHeaders_[j].msg_hdr.msg_flags & MSG_TRUNC ){
+                    truncatedCount_.fetch_add( 1, std::memory_order_relaxed );
+                    listener->ProcessTruncatedPacket( maxDatagramSize_, remoteEndpoint );
+                }else{
+                    listener->ProcessTimestampedPacket( &batchData_[ (std::size_t)j * maxDatagramSize_ ],
+                            (int)batchHeaders_[j].msg_len, remoteEndpoint,
+                            ArrivalTimeFromMessageHeader( batchHeaders_[j].msg_hdr ) );
+                }
+                if( break_ )
+                    break;
+            }
+            return (count > 0) ? (unsigned int)count : 0;
+        }
+#endif
+
+        // unless nonBlocking is set the first read may block (select() reported
+        // the socket readable), the rest must not
+        unsigned int count = 0;
+        for( int j=0; j < batchSize_; ++j ){
+            unsigned long long arrivalTimeNs = 0;
+            bool truncated = false;
+            std::size_t size = socket->impl_->ReceiveFrom( remoteEndpoint, data, (std::size_t)maxDatagramSize_,
+                    (j == 0 && !nonBlocking) ? 0 : MSG_DONTWAIT, arrivalTimeNs, truncated );
+            if( size == 0 )
+                break;
+
+            ++count;
+            if( truncated ){
+                truncatedCount_.fetch_add( 1, std::memory_order_relaxed );
+                listener->ProcessTruncatedPacket( maxDatagramSize_, remoteEndpoint );
+            }else{
+                listener->ProcessTimestampedPacket( data, (int)size, remoteEndpoint, arrivalTimeNs );
+            }
+            if( break_ )
+                break;
+        }
+        if( count > 0 )
+            RecordBatch( count );
+        return count;
+    }
+
+    typedef std::vector< ScheduledTimerCall > TimerQueue;
+
+    void InitializeTimerQueue( TimerQueue& timerQueue ) const
+    {
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+
+        for( std::vector< AttachedTimerListener >::const_iterator i = timerListeners_.begin();
+                i != timerListeners_.end(); ++i )
+            timerQueue.push_back( std::make_pair( currentTimeNs + (unsigned long long)i->initialDelayMs * 1000000ULL, *i ) );
+        std::make_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+    }
+
+    // milliseconds until the next timer expires, or -1 if there are no timers
+    double TimeUntilNextTimerMs( const TimerQueue& timerQueue ) const
+    {
+        if( timerQueue.empty() )
+            return -1;
+
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+        if( timerQueue.front().first <= currentTimeNs )
+            return 0;
+
+        return (double)(timerQueue.front().first - currentTimeNs) * 1e-6;
+    }
+
+    // O(log n) per expired timer: only the expired timers leave and re-enter the heap
+    void ExecuteExpiredTimers( TimerQueue& timerQueue )
+    {
+        unsigned long long currentTimeNs = GetMonotonicClockNanoseconds();
+
+        // each timer fires at most once per call, even with a zero period
+        for( std::size_t n = timerQueue.size();
+                n > 0 && timerQueue.front().first <= currentTimeNs; --n ){
+
+            std::pop_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+            ScheduledTimerCall& timer = timerQueue.back();
+            TimerListener *listener = timer.second.listener;
+
+            // periods missed while the thread was busy are skipped rather than
+            // fired in a burst: the timer stays on its schedule, at most one
+            // period overdue
+            unsigned long long periodNs = (unsigned long long)timer.second.periodMs * 1000000ULL;
+            timer.first += periodNs;
+            if( periodNs > 0 && timer.first + periodNs <= currentTimeNs )
+                timer.first += ((currentTimeNs - timer.first) / periodNs) * periodNs;
+            std::push_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+
+            listener->TimerExpired();
+            if( break_ )
+                break;
+        }
+    }
+
+    int BreakDescriptor() const
+    {
+#ifdef OSC_HAVE_EPOLL
+        return breakEvent_;
+#else
+        return breakPipe_[0];
+#endif
+    }
+
+    // clear pending data from the asynchronous break descriptor
+    void ClearBreakSignal()
+    {
+#ifdef OSC_HAVE_EPOLL
+        uint64_t value;
+        read( breakEvent_, &value, sizeof(value) );
+#else
+        char c;
+        read( breakPipe_[0], &c, 1 );
+#endif
+    }
+
+    void RunSelect( char *data )
+    {
+        // configure the master fd_set for select()
+
+        fd_set masterfds, tempfds;
+        FD_ZERO( &masterfds );
+        FD_ZERO( &tempfds );
+
+        // in addition to listening to the inbound sockets we
+        // also listen to the asynchronous break descriptor, so that AsynchronousBreak()
+        // can break us out of select() from another thread.
+        FD_SET( BreakDescriptor(), &masterfds );
+        int fdmax = BreakDescriptor();
+
+        for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
+                i != socketListeners_.end(); ++i ){
+
+            if( fdmax < i->second->impl_->Socket() )
+                fdmax = i->second->impl_->Socket();
+            FD_SET( i->second->impl_->Socket(), &masterfds );
+        }
+
+        TimerQueue timerQueue_;
+        InitializeTimerQueue( timerQueue_ );
+
+        struct timeval timeout;
+
+        while( !break_ ){
+            tempfds = masterfds;
+
+            struct timeval *timeoutPtr = 0;
+            double timeoutMs = TimeUntilNextTimerMs( timerQueue_ );
+            if( timeoutMs >= 0 ){
+                long timoutSecondsPart = (long)(timeoutMs * .001);
+                timeout.tv_sec = (time_t)timoutSecondsPart;
+                // 1000000 microseconds in a second
+                timeout.tv_usec = (suseconds_t)((timeoutMs - (timoutSecondsPart * 1000)) * 1000);
+                timeoutPtr = &timeout;
+            }
+
+            if( select( fdmax + 1, &tempfds, 0, 0, timeoutPtr ) < 0 ){
+                if( break_ ){
+                    break;
+                }else if( errno == EINTR ){
+                    // on returning an error, select() doesn't clear tempfds.
+                    // so tempfds would remain all set, which would cause read( breakPipe_[0]...
+                    // below to block indefinitely. therefore if select returns EINTR we restart
+                    // the while() loop instead of continuing on to below.
+                    continue;
+                }else{
+                    throw std::runtime_error("select failed\n");
+                }
+            }
+
+            if( FD_ISSET( BreakDescriptor(), &tempfds ) )
+                ClearBreakSignal();
+
+            if( break_ )
+                break;
+
+            for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
+                    i != socketListeners_.end(); ++i ){
+
+                if( FD_ISSET( i->second->impl_->Socket(), &tempfds ) ){
+
+                    ReceiveDatagrams( i->first, i->second, data, false );
+                    if( break_ )
+                        break;
+                }
+            }
+
+            // execute any expired timers
+            ExecuteExpiredTimers( timerQueue_ );
+        }
+    }
+
+#ifdef OSC_HAVE_EPOLL
+    void RunEpoll( char *data )
+    {
+        enum { MAX_EVENTS = 64 };
+        const uint32_t BREAK_EVENT_ID = 0xFFFFFFFF;
+        const uint32_t TIMER_EVENT_ID = 0xFFFFFFFE;
+
+        int epollFd = epoll_create1( EPOLL_CLOEXEC );
+        if( epollFd < 0 )
+            throw std::runtime_error( "epoll_create1 failed\n" );
+
+        // epoll_wait() only takes a timeout in milliseconds, so timers wake
+        // the loop through a timerfd armed for the next expiry instead
+        int timerFd = -1;
+        unsigned long long armedTimeNs = 0;
+
+        try{
+            // the break eventfd stays level-triggered so a pending break is never missed
+            struct epoll_event event;
+            std::memset( &event, 0, sizeof(event) );
+            event.events = EPOLLIN;
+            event.data.u32 = BREAK_EVENT_ID;
+            if( epoll_ctl( epollFd, EPOLL_CTL_ADD, breakEvent_, &event ) < 0 )
+                throw std::runtime_error( "epoll_ctl failed\n" );
+
+            // sockets are edge-triggered: a socket is only reported again once new
+            // data arrives, so it is kept in the ready list until it has been drained
+            for( std::size_t i = 0; i < socketListeners_.size(); ++i ){
+                event.events = EPOLLIN | EPOLLET;
+                event.data.u32 = (uint32_t)i;
+                if( epoll_ctl( epollFd, EPOLL_CTL_ADD, socketListeners_[i].second->impl_->Socket(), &event ) < 0 )
+                    throw std::runtime_error( "epoll_ctl failed\n" );
+            }
+
+            std::vector< uint32_t > readySockets;
+            readySockets.reserve( socketListeners_.size() );
+            std::vector< char > isReady( socketListeners_.size(), 0 );
+
+            struct epoll_event events[ MAX_EVENTS ];
+
+            TimerQueue timerQueue_;
+            InitializeTimerQueue( timerQueue_ );
+
+            if( !timerQueue_.empty() ){
+                timerFd = timerfd_create( CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK );
+                if( timerFd >= 0 ){
+                    event.events = EPOLLIN;
+                    event.data.u32 = TIMER_EVENT_ID;
+                    if( epoll_ctl( epollFd, EPOLL_CTL_ADD, timerFd, &event ) < 0 ){
+                        close( timerFd );
+                        timerFd = -1;
+                    }
+                }
+            }
+
+            while( !break_ ){
+
+                // don't sleep while sockets still hold undrained datagrams
+                int timeout = -1;
+                if( !readySockets.empty() ){
+                    timeout = 0;
+                }else{
+                    double timeoutMs = TimeUntilNextTimerMs( timerQueue_ );
+                    if( timeoutMs == 0 ){
+                        timeout = 0;
+                    }else if( timeoutMs > 0 ){
+                        if( timerFd >= 0 ){
+                            if( timerQueue_.front().first != armedTimeNs ){
+                                armedTimeNs = timerQueue_.front().first;
+
+                                struct itimerspec expiry;
+                                std::memset( &expiry, 0, sizeof(expiry) );
+                                expiry.it_value.tv_sec = (time_t)(armedTimeNs / 1000000000ULL);
+                                expiry.it_value.tv_nsec = (long)(armedTimeNs % 1000000000ULL);
+                                timerfd_settime( timerFd, TFD_TIMER_ABSTIME, &expiry, 0 );
+                            }
+                        }else{
+                            timeout = (int)ceil( timeoutMs );
+                        }
+                    }
+                }
+
+                int eventCount = epoll_wait( epollFd, events, MAX_EVENTS, timeout );
+                if( eventCount < 0 ){
+                    if( break_ )
+                        break;
+                    else if( errno == EINTR )
+                        continue;
+                    else
+                        throw std::runtime_error( "epoll_wait failed\n" );
+                }
+
+                for( int i = 0; i < eventCount; ++i ){
+                    uint32_t id = events[i].data.u32;
+                    if( id == BREAK_EVENT_ID ){
+                        ClearBreakSignal();
+                    }else if( id == TIMER_EVENT_ID ){
+                        uint64_t expirations;
+                        ssize_t bytes = read( timerFd, &expirations, sizeof(expirations) );
+                        (void) bytes; // only clears the readiness, the timer queue says what expired
+                    }else if( !isReady[id] ){
+                        isReady[id] = 1;
+                        readySockets.push_back( id );
+                    }
+                }
+
+                if( break_ )
+                    break;
+
+                // one batch per ready socket per pass, so a busy socket can't starve the others
+                std::size_t j = 0;
+                for( std::size_t i = 0; i < readySockets.size(); ++i ){
+                    uint32_t id = readySockets[i];
+                    unsigned int count = ReceiveDatagrams( socketListeners_[id].first,
+                            socketListeners_[id].second, data, true );
+
+                    if( count < (unsigned int)batchSize_ )
+                        isReady[id] = 0; // drained
+                    else
+                        readySockets[j++] = id;
+
+                    if( break_ )
+                        break;
+                }
+                if( break_ )
+                    break;
+                readySockets.resize( j );
+
+                // execute any expired timers
+                ExecuteExpiredTimers( timerQueue_ );
+            }
+        }catch(...){
+            if( timerFd >= 0 )
+                close( timerFd );
+            close( epollFd );
+            throw;
+        }
+
+        if( timerFd >= 0 )
+            close( timerFd );
+        close( epollFd );
+    }
+#endif
+
 public:
     Implementation()
+        : batchSize_( 1 )
+        , maxDatagramSize_( SocketReceiveMultiplexer::DEFAULT_MAX_DATAGRAM_SIZE )
+        , data_( SocketReceiveMultiplexer::DEFAULT_MAX_DATAGRAM_SIZE )
+        , batchCount_( 0 )
+        , datagramCount_( 0 )
+        , truncatedCount_( 0 )
+        , lastBatchSize_( 0 )
+        , maxBatchSize_( 0 )
     {
+#if defined(OSC_HAVE_EPOLL) && OSC_USE_EPOLL
+        backend_ = SocketReceiveMultiplexer::EPOLL_BACKEND;
+#else
+        backend_ = SocketReceiveMultiplexer::SELECT_BACKEND;
+#endif
+
+#ifdef OSC_HAVE_EPOLL
+        breakEvent_ = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+        if( breakEvent_ < 0 )
+            throw std::runtime_error( "creation of asynchronous break eventfd failed\n" );
+#else
         if( pipe(breakPipe_) != 0 )
             throw std::runtime_error( "creation of asynchronous break pipes failed\n" );
+#endif
     }
 
     ~Implementation()
     {
+#ifdef OSC_HAVE_EPOLL
+        close( breakEvent_ );
+#else
         close( breakPipe_[0] );
         close( breakPipe_[1] );
+#endif
     }
 
     void AttachSocketListener( UdpSocket *socket, PacketListener *listener )
@@ -935,126 +1734,59 @@ public:
         timerListeners_.erase( i );
     }
 
-    void Run()
+    void SetBackend( SocketReceiveMultiplexer::Backend backend )
     {
-        break_ = false;
-        char *data = 0;
-
-        try{
-
-            // configure the master fd_set for select()
-
-            fd_set masterfds, tempfds;
-            FD_ZERO( &masterfds );
-            FD_ZERO( &tempfds );
-
-            // in addition to listening to the inbound sockets we
-            // also listen to the asynchronous break pipe, so that AsynchronousBreak()
-            // can break us out of select() from another thread.
-            FD_SET( breakPipe_[0], &masterfds );
-            int fdmax = breakPipe_[0];
-
-            for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
-                    i != socketListeners_.end(); ++i ){
-
-                if( fdmax < i->second->impl_->Socket() )
-                    fdmax = i->second->impl_->Socket();
-                FD_SET( i->second->impl_->Socket(), &masterfds );
-            }
-
-
-            // configure the timer queue
-            double currentTimeMs = GetCurrentTimeMs();
-
-            // expiry time ms, listener
-            std::vector< std::pair< double, AttachedTimerListener > > timerQueue_;
-            for( std::vector< AttachedTimerListener >::iterator i = timerListeners_.begin();
-                    i != timerListeners_.end(); ++i )
-                timerQueue_.push_back( std::make_pair( currentTimeMs + i->initialDelayMs, *i ) );
-            std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
-
-            const int MAX_BUFFER_SIZE = 4098;
-            data = new char[ MAX_BUFFER_SIZE ];
-            IpEndpointName remoteEndpoint;
-
-            struct timeval timeout;
-
-            while( !break_ ){
-                tempfds = masterfds;
-
-                struct timeval *timeoutPtr = 0;
-                if( !timerQueue_.empty() ){
-                    double timeoutMs = timerQueue_.front().first - GetCurrentTimeMs();
-                    if( timeoutMs < 0 )
-                        timeoutMs = 0;
-
-                    long timoutSecondsPart = (long)(timeoutMs * .001);
-                    timeout.tv_sec = (time_t)timoutSecondsPart;
-                    // 1000000 microseconds in a second
-                    timeout.tv_usec = (suseconds_t)((timeoutMs - (timoutSecondsPart * 1000)) * 1000);
-                    timeoutPtr = &timeout;
-                }
+#ifdef OSC_HAVE_EPOLL
+        backend_ = backend;
+#else
+        (void) backend; // only select() is available on this platform
+#endif
+    }
 
-                if( select( fdmax + 1, &tempfds, 0, 0, timeoutPtr ) < 0 ){
-                    if( break_ ){
-                        break;
-                    }else if( errno == EINTR ){
-                        // on returning an error, select() doesn't clear tempfds.
-                        // so tempfds would remain all set, which would cause read( breakPipe_[0]...
-                        // below to block indefinitely. therefore if select returns EINTR we restart
-                        // the while() loop instead of continuing on to below.
-                        continue;
-                    }else{
-                        throw std::runtime_error("select failed\n");
-                    }
-                }
+    SocketReceiveMultiplexer::Backend GetBackend() const { return backend_; }
 
-                if( FD_ISSET( breakPipe_[0], &tempfds ) ){
-                    // clear pending data from the asynchronous break pipe
-                    char c;
-                    read( breakPipe_[0], &c, 1 );
-                }
+    void SetReceiveBatchSize( int maxDatagrams )
+    {
+        batchSize_ = (maxDatagrams < 1) ? 1 : maxDatagrams;
 
-                if( break_ )
-                    break;
+        // preallocate the receive slab so Run() never allocates per batch
+        AllocateReceiveBuffers();
+    }
 
-                for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
-                        i != socketListeners_.end(); ++i ){
+    void SetMaxDatagramSize( int bytes )
+    {
+        maxDatagramSize_ = (bytes < 1) ? 1
+                : (bytes > SocketReceiveMultiplexer::MAX_DATAGRAM_SIZE) ? SocketReceiveMultiplexer::MAX_DATAGRAM_SIZE : bytes;
 
-                    if( FD_ISSET( i->second->impl_->Socket(), &tempfds ) ){
+        AllocateReceiveBuffers();
+    }
 
-                        std::size_t size = i->second->ReceiveFrom( remoteEndpoint, data, MAX_BUFFER_SIZE );
-                        if( size > 0 ){
-                            i->first->ProcessPacket( data, (int)size, remoteEndpoint );
-                            if( break_ )
-                                break;
-                        }
-                    }
-                }
+    int GetMaxDatagramSize() const { return maxDatagramSize_; }
 
-                // execute any expired timers
-                currentTimeMs = GetCurrentTimeMs();
-                bool resort = false;
-                for( std::vector< std::pair< double, AttachedTimerListener > >::iterator i = timerQueue_.begin();
-                        i != timerQueue_.end() && i->first <= currentTimeMs; ++i ){
+    SocketReceiveMultiplexer::ReceiveStatistics GetReceiveStatistics() const
+    {
+        SocketReceiveMultiplexer::ReceiveStatistics result;
+        result.batchCount = batchCount_.load( std::memory_order_relaxed );
+        result.datagramCount = datagramCount_.load( std::memory_order_relaxed );
+        result.truncatedCount = truncatedCount_.load( std::memory_order_relaxed );
+        result.lastBatchSize = lastBatchSize_.load( std::memory_order_relaxed );
+        result.maxBatchSize = maxBatchSize_.load( std::memory_order_relaxed );
+        return result;
+    }
 
-                    i->second.listener->TimerExpired();
-                    if( break_ )
-                        break;
+    void Run()
+    {
+        break_ = false;
 
-                    i->first += i->second.periodMs;
-                    resort = true;
-                }
-                if( resort )
-                    std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
-            }
+        // the receive buffer is allocated by SetMaxDatagramSize(), not per Run()
+        char *data = &data_[0];
 
-            delete [] data;
-        }catch(...){
-            if( data )
-                delete [] data;
-            throw;
-        }
+#ifdef OSC_HAVE_EPOLL
+        if( backend_ == SocketReceiveMultiplexer::EPOLL_BACKEND )
+            RunEpoll( data );
+        else
+#endif
+            RunSelect( data );
     }
 
     void Break()
@@ -1066,8 +1798,13 @@ public:
     {
         break_ = true;
 
-        // Send a termination message to the asynchronous break pipe, so select() will return
+        // Send a termination message to the asynchronous break descriptor, so select() will return
+#ifdef OSC_HAVE_EPOLL
+        uint64_t value = 1;
+        write( breakEvent_, &value, sizeof(value) );
+#else
         write( breakPipe_[1], "!", 1 );
+#endif
     }
 };
 
@@ -1108,6 +1845,36 @@ void SocketReceiveMultiplexer::DetachPeriodicTimerListener( TimerListener *liste
     impl_->DetachPeriodicTimerListener( listener );
 }
 
+void SocketReceiveMultiplexer::SetBackend( Backend backend )
+{
+    impl_->SetBackend( backend );
+}
+
+SocketReceiveMultiplexer::Backend SocketReceiveMultiplexer::GetBackend() const
+{
+    return impl_->GetBackend();
+}
+
+void SocketReceiveMultiplexer::SetReceiveBatchSize( int maxDatagrams )
+{
+    impl_->SetReceiveBatchSize( maxDatagrams );
+}
+
+void SocketReceiveMultiplexer::SetMaxDatagramSize( int bytes )
+{
+    impl_->SetMaxDatagramSize( bytes );
+}
+
+int SocketReceiveMultiplexer::GetMaxDatagramSize() const
+{
+    return impl_->GetMaxDatagramSize();
+}
+
+SocketReceiveMultiplexer::ReceiveStatistics SocketReceiveMultiplexer::GetReceiveStatistics() const
+{
+    return impl_->GetReceiveStatistics();
+}
+
 void SocketReceiveMultiplexer::Run()
 {
     impl_->Run();
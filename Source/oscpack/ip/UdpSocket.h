@@ -46,6 +46,17 @@
 class PacketListener;
 class TimerListener;
 
+
+// Returns the current time on the clock used for packet arrival times
+// (nanoseconds since the unix epoch on the system real-time clock, the
+// clock the kernel uses for SO_TIMESTAMPNS receive time stamps).
+unsigned long long GetPacketClockNanoseconds();
+
+// Returns the current time on a monotonic clock (nanoseconds since an
+// arbitrary point, unaffected by system clock changes). Timers attached
+// with SocketReceiveMultiplexer::AttachPeriodicTimerListener() run on it.
+unsigned long long GetMonotonicClockNanoseconds();
+
 class UdpSocket;
 
 class SocketReceiveMultiplexer{
@@ -64,11 +75,48 @@ public:
     void AttachSocketListener( UdpSocket *socket, PacketListener *listener );
     void DetachSocketListener( UdpSocket *socket, PacketListener *listener );
 
+    // Timers are scheduled on GetMonotonicClockNanoseconds() and kept in a
+    // binary heap. A timer that falls behind by whole periods skips them
+    // instead of firing in a burst.
     void AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener );
 	void AttachPeriodicTimerListener(
             int initialDelayMilliseconds, int periodMilliseconds, TimerListener *listener );
     void DetachPeriodicTimerListener( TimerListener *listener );  
 
+    // Event notification mechanism used by Run(). EPOLL_BACKEND (edge-triggered
+    // epoll, no FD_SETSIZE limit and no per-wakeup rescan of all sockets) is
+    // only available on Linux; elsewhere the request is ignored and
+    // SELECT_BACKEND is used. Building with OSC_USE_EPOLL=1 makes epoll the default.
+    enum Backend{ SELECT_BACKEND, EPOLL_BACKEND };
+    void SetBackend( Backend backend );
+    Backend GetBackend() const;
+
+    // Receive up to maxDatagrams datagrams from a socket each time it
+    // becomes readable (recvmmsg() on Linux). Datagrams are still passed
+    // to PacketListener::ProcessPacket() one at a time, in arrival order.
+    // The receive buffers are preallocated here. Default is 1.
+    void SetReceiveBatchSize( int maxDatagrams );
+
+    // Size of the buffer each datagram is received into, up to
+    // MAX_DATAGRAM_SIZE (the largest UDP datagram). Larger datagrams are
+    // detected (MSG_TRUNC), counted, passed to
+    // PacketListener::ProcessTruncatedPacket() and otherwise dropped.
+    // The buffers are preallocated here, not in Run(). Only call before Run().
+    enum { DEFAULT_MAX_DATAGRAM_SIZE = 4098, MAX_DATAGRAM_SIZE = 65536 };
+    void SetMaxDatagramSize( int bytes );
+    int GetMaxDatagramSize() const;
+
+    struct ReceiveStatistics{
+        unsigned long long batchCount;    // number of non-empty socket reads
+        unsigned long long datagramCount; // total datagrams received
+        unsigned long long truncatedCount; // datagrams dropped for exceeding the receive buffer
+        unsigned int lastBatchSize;       // datagrams received by the most recent read
+        unsigned int maxBatchSize;        // largest batch seen so far
+    };
+
+    // safe to call from any thread while Run() is executing
+    ReceiveStatistics GetReceiveStatistics() const;
+
     void Run();      // loop and block processing messages indefinitely
 	void RunUntilSigInt();
     void Break();    // call this from a listener to exit once the listener returns
@@ -102,6 +150,16 @@ public:
 	// operating systems.
 	void SetAllowReuse( bool allowReuse );
 
+	// Let several sockets bind the same local endpoint and have the kernel
+	// spread incoming datagrams across them, hashed by source address and
+	// port, so each sender stays on one socket (SO_REUSEPORT on Linux).
+	// Must be called before Bind() on every socket sharing the endpoint.
+	// Returns false where datagrams are not load balanced this way.
+	bool SetEnableReusePort( bool enableReusePort );
+
+	// true if SetEnableReusePort() is supported on this platform
+	static bool IsReusePortSupported();
+
 
 	// The socket is created in an unbound, unconnected state
 	// such a socket can only be used to send to an arbitrary
@@ -162,10 +220,26 @@ public:
         mux_.AttachSocketListener( this, listener_ );
     }
 
+    // one of several sockets sharing localEndpoint, see SetEnableReusePort()
+    UdpListeningReceiveSocket( const IpEndpointName& localEndpoint, PacketListener *listener, bool reusePort )
+        : listener_( listener )
+    {
+        if( reusePort )
+            SetEnableReusePort( true );
+        Bind( localEndpoint );
+        mux_.AttachSocketListener( this, listener_ );
+    }
+
     ~UdpListeningReceiveSocket()
         { mux_.DetachSocketListener( this, listener_ ); }
 
     // see SocketReceiveMultiplexer above for the behaviour of these methods...
+    void SetBackend( SocketReceiveMultiplexer::Backend backend ) { mux_.SetBackend( backend ); }
+    void SetReceiveBatchSize( int maxDatagrams ) { mux_.SetReceiveBatchSize( maxDatagrams ); }
+    void SetMaxDatagramSize( int bytes ) { mux_.SetMaxDatagramSize( bytes ); }
+    int GetMaxDatagramSize() const { return mux_.GetMaxDatagramSize(); }
+    SocketReceiveMultiplexer::ReceiveStatistics GetReceiveStatistics() const { return mux_.GetReceiveStatistics(); }
+
     void Run() { mux_.Run(); }
 	void RunUntilSigInt() { mux_.RunUntilSigInt(); }
     void Break() { mux_.Break(); }
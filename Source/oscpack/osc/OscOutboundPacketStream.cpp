@@ -49,6 +49,16 @@
 
 #include "OscHostEndianness.h"
 
+#if defined(OSC_HOST_LITTLE_ENDIAN)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_FLOAT_SWAP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OSC_FLOAT_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
 #if defined(__BORLANDC__) // workaround for BCB4 release build intrinsics bug
 namespace std {
 using ::__strcpy__;  // avoid error: E2316 '__strcpy__' is not a member of 'std'.
@@ -255,9 +265,15 @@ void OutboundPacketStream::CheckForAvailableMessageSpace( const char *addressPat
 
 void OutboundPacketStream::CheckForAvailableArgumentSpace( std::size_t argumentLength )
 {
-    // plus three for extra type tag, comma and null terminator
+    CheckForAvailableArgumentSpace( argumentLength, 1 );
+}
+
+
+void OutboundPacketStream::CheckForAvailableArgumentSpace( std::size_t argumentLength, std::size_t typeTagCount )
+{
+    // plus two for comma and null terminator
     std::size_t required = (argumentCurrent_ - data_) + argumentLength
-            + RoundUp4( (end_ - typeTagsCurrent_) + 3 );
+            + RoundUp4( (end_ - typeTagsCurrent_) + typeTagCount + 2 );
 
     if( required > Capacity() )
         throw OutOfBufferMemoryException();
@@ -658,6 +674,73 @@ OutboundPacketStream& OutboundPacketStream::operator<<( const Blob& rhs )
     return *this;
 }
 
+// writes count floats in big-endian byte order
+static void FromFloat32Array( char *p, const float *values, std::size_t count )
+{
+#ifdef OSC_HOST_LITTLE_ENDIAN
+    std::size_t i = 0;
+
+#if defined(OSC_FLOAT_SWAP_SSE2)
+    for( ; i + 4 <= count; i += 4 ){
+        __m128i x = _mm_loadu_si128( (const __m128i*)(values + i) );
+
+        // swap the 16 bit halves of each word, then the bytes of each half
+        x = _mm_or_si128( _mm_slli_epi32( x, 16 ), _mm_srli_epi32( x, 16 ) );
+        x = _mm_or_si128( _mm_slli_epi16( x, 8 ), _mm_srli_epi16( x, 8 ) );
+
+        _mm_storeu_si128( (__m128i*)(p + 4 * i), x );
+    }
+#elif defined(OSC_FLOAT_SWAP_NEON)
+    for( ; i + 4 <= count; i += 4 ){
+        uint8x16_t x = vld1q_u8( (const uint8_t*)(values + i) );
+        vst1q_u8( (uint8_t*)(p + 4 * i), vrev32q_u8( x ) );
+    }
+#endif
+
+    for( ; i < count; ++i ){
+        const char *c = (const char*)(values + i);
+        char *d = p + 4 * i;
+
+        d[0] = c[3];
+        d[1] = c[2];
+        d[2] = c[1];
+        d[3] = c[0];
+    }
+#else
+    std::memcpy( p, values, 4 * count );
+#endif
+}
+
+
+OutboundPacketStream& OutboundPacketStream::operator<<( const Float32Array& rhs )
+{
+    CheckForAvailableArgumentSpace( 4 * (std::size_t)rhs.count, rhs.count );
+
+    typeTagsCurrent_ -= rhs.count;
+    std::memset( typeTagsCurrent_, FLOAT_TYPE_TAG, rhs.count );
+
+    FromFloat32Array( argumentCurrent_, rhs.data, rhs.count );
+    argumentCurrent_ += 4 * (std::size_t)rhs.count;
+
+    return *this;
+}
+
+
+OutboundPacketStream& OutboundPacketStream::operator<<( const Float32Blob& rhs )
+{
+    CheckForAvailableArgumentSpace( 4 + 4 * (std::size_t)rhs.count );
+
+    *(--typeTagsCurrent_) = BLOB_TYPE_TAG;
+    FromUInt32( argumentCurrent_, 4 * rhs.count );
+    argumentCurrent_ += 4;
+
+    // a whole number of words, no padding needed
+    FromFloat32Array( argumentCurrent_, rhs.data, rhs.count );
+    argumentCurrent_ += 4 * (std::size_t)rhs.count;
+
+    return *this;
+}
+
 OutboundPacketStream& OutboundPacketStream::operator<<( const ArrayInitiator& rhs )
 {
     (void) rhs;
@@ -121,6 +121,11 @@ public:
     OutboundPacketStream& operator<<( const Symbol& rhs );
     OutboundPacketStream& operator<<( const Blob& rhs );
 
+    // bulk float32 output: the values are byte swapped with SIMD where
+    // available, and the type tags of an array are written at once
+    OutboundPacketStream& operator<<( const Float32Array& rhs );
+    OutboundPacketStream& operator<<( const Float32Blob& rhs );
+
     OutboundPacketStream& operator<<( const ArrayInitiator& rhs );
     OutboundPacketStream& operator<<( const ArrayTerminator& rhs );
 
@@ -133,6 +138,7 @@ private:
     void CheckForAvailableBundleSpace();
     void CheckForAvailableMessageSpace( const char *addressPattern );
     void CheckForAvailableArgumentSpace( std::size_t argumentLength );
+    void CheckForAvailableArgumentSpace( std::size_t argumentLength, std::size_t typeTagCount );
 
     char *data_;
     char *end_;
@@ -44,33 +44,122 @@
 namespace osc{
 
 class OscPacketListener : public PacketListener{ 
+    unsigned long long packetArrivalTimeNs_;
+    uint64 bundleTimeTag_;
+
+    void DispatchPacket( const char *data, int size,
+			const IpEndpointName& remoteEndpoint )
+    {
+        bundleTimeTag_ = 1;
+
+        // validated without exceptions, so malformed traffic stays cheap to reject
+        const char *error = 0;
+
+        osc::ReceivedPacket p( data, size, error );
+        if( error ){
+            ProcessMalformedPacket( error, remoteEndpoint );
+            return;
+        }
+
+        if( p.IsBundle() ){
+            ReceivedBundle b( p, error );
+            if( error )
+                ProcessMalformedPacket( error, remoteEndpoint );
+            else
+                ProcessBundle( b, remoteEndpoint );
+        }else{
+            ReceivedMessage m( p, error );
+            if( error )
+                ProcessMalformedPacket( error, remoteEndpoint );
+            else
+                ProcessMessage( m, remoteEndpoint );
+        }
+    }
+
 protected:
+    // arrival time of the packet currently being processed (nanoseconds,
+    // see GetPacketClockNanoseconds()), or 0 if it is unknown
+    unsigned long long PacketArrivalTime() const { return packetArrivalTimeNs_; }
+
+    // NTP time tag of the innermost bundle enclosing the message currently
+    // being processed, 1 ("immediately") for messages outside of bundles
+    uint64 BundleTimeTag() const { return bundleTimeTag_; }
+
+    // BundleTimeTag() converted to the packet clock (nanoseconds since the
+    // unix epoch, see GetPacketClockNanoseconds()), or 0 for "immediately"
+    unsigned long long BundleTime() const
+    {
+        const uint64 ntpUnixOffsetSeconds = 2208988800ULL; // 1900-01-01 to 1970-01-01
+
+        if( bundleTimeTag_ <= 1 )
+            return 0;
+
+        uint64 seconds = bundleTimeTag_ >> 32;
+        uint64 fraction = bundleTimeTag_ & 0xFFFFFFFFULL;
+
+        if( seconds < ntpUnixOffsetSeconds )
+            return 1; // long past: due as soon as possible
+
+        return (seconds - ntpUnixOffsetSeconds) * 1000000000ULL
+                + ((fraction * 1000000000ULL) >> 32);
+    }
+
     virtual void ProcessBundle( const osc::ReceivedBundle& b, 
 				const IpEndpointName& remoteEndpoint )
     {
-        // ignore bundle time tag for now
+        // nested bundles carry their own (later or equal) time tag
+        uint64 enclosingTimeTag = bundleTimeTag_;
+        bundleTimeTag_ = b.TimeTag();
 
         for( ReceivedBundle::const_iterator i = b.ElementsBegin(); 
 				i != b.ElementsEnd(); ++i ){
-            if( i->IsBundle() )
-                ProcessBundle( ReceivedBundle(*i), remoteEndpoint );
-            else
-                ProcessMessage( ReceivedMessage(*i), remoteEndpoint );
+            const char *error = 0;
+
+            if( i->IsBundle() ){
+                ReceivedBundle element( *i, error );
+                if( error )
+                    ProcessMalformedPacket( error, remoteEndpoint );
+                else
+                    ProcessBundle( element, remoteEndpoint );
+            }else{
+                ReceivedMessage element( *i, error );
+                if( error )
+                    ProcessMalformedPacket( error, remoteEndpoint );
+                else
+                    ProcessMessage( element, remoteEndpoint );
+            }
         }
+
+        bundleTimeTag_ = enclosingTimeTag;
     }
 
     virtual void ProcessMessage( const osc::ReceivedMessage& m, 
 				const IpEndpointName& remoteEndpoint ) = 0;
+
+    // called instead of ProcessMessage()/ProcessBundle() for packets or
+    // bundle elements that are not well formed. the default ignores them
+    virtual void ProcessMalformedPacket( const char *error,
+				const IpEndpointName& remoteEndpoint )
+    {
+        (void) error; // suppress unused parameter warnings
+        (void) remoteEndpoint;
+    }
     
 public:
+    OscPacketListener() : packetArrivalTimeNs_( 0 ), bundleTimeTag_( 1 ) {}
+
 	virtual void ProcessPacket( const char *data, int size, 
 			const IpEndpointName& remoteEndpoint )
     {
-        osc::ReceivedPacket p( data, size );
-        if( p.IsBundle() )
-            ProcessBundle( ReceivedBundle(p), remoteEndpoint );
-        else
-            ProcessMessage( ReceivedMessage(p), remoteEndpoint );
+        packetArrivalTimeNs_ = 0;
+        DispatchPacket( data, size, remoteEndpoint );
+    }
+
+    virtual void ProcessTimestampedPacket( const char *data, int size,
+			const IpEndpointName& remoteEndpoint, unsigned long long arrivalTimeNs )
+    {
+        packetArrivalTimeNs_ = arrivalTimeNs;
+        DispatchPacket( data, size, remoteEndpoint );
     }
 };
 
@@ -37,6 +37,7 @@
 #include "OscReceivedElements.h"
 
 #include "OscHostEndianness.h"
+#include "OscStringScan.h"
 
 #include <cstddef> // ptrdiff_t
 
@@ -70,16 +71,17 @@ static inline const char* FindStr4End( const char *p, const char *end )
 	if( p[0] == '\0' )    // special case for SuperCollider integer address pattern
 		return p + 4;
 
-    p += 3;
-    end -= 1;
-
-    while( p < end && *p )
-        p += 4;
+    // type tags and short addresses such as "/ttl" end within two words,
+    // where an inline check beats a call into the vector kernels
+    if( end - p >= 8 ){
+        if( !p[3] )
+            return p + 4;
+        if( !p[7] )
+            return p + 8;
+    }
 
-    if( *p )
-        return 0;
-    else
-        return p + 1;
+    // SSE2/AVX2/NEON scan, chosen at startup (see OscStringScan.h)
+    return FindStr4EndBounded( p, end );
 }
 
 
@@ -449,6 +451,20 @@ void ReceivedMessageArgument::AsBlobUnchecked( const void*& data, osc_bundle_ele
 	data = (void*)(argumentPtr_+ osc::OSC_SIZEOF_INT32);
 }
 
+bool ReceivedMessageArgument::TryAsBlob( const void*& data, osc_bundle_element_size_t& size ) const
+{
+    if( !typeTagPtr_ || !IsBlob() )
+        return false;
+
+    osc_bundle_element_size_t sizeResult = (osc_bundle_element_size_t)ToUInt32( argumentPtr_ );
+    if( !IsValidElementSizeValue(sizeResult) )
+        return false;
+
+    size = sizeResult;
+	data = (void*)(argumentPtr_+ osc::OSC_SIZEOF_INT32);
+    return true;
+}
+
 std::size_t ReceivedMessageArgument::ComputeArrayItemCount() const
 {
     // it is only valid to call ComputeArrayItemCount when the argument is the array start marker
@@ -559,14 +575,45 @@ void ReceivedMessageArgumentIterator::Advance()
 ReceivedMessage::ReceivedMessage( const ReceivedPacket& packet )
     : addressPattern_( packet.Contents() )
 {
-    Init( packet.Contents(), packet.Size() );
+    const char *error = Init( packet.Contents(), packet.Size() );
+    if( error )
+        throw MalformedMessageException( error );
 }
 
 
 ReceivedMessage::ReceivedMessage( const ReceivedBundleElement& bundleElement )
     : addressPattern_( bundleElement.Contents() )
 {
-    Init( bundleElement.Contents(), bundleElement.Size() );
+    const char *error = Init( bundleElement.Contents(), bundleElement.Size() );
+    if( error )
+        throw MalformedMessageException( error );
+}
+
+
+ReceivedMessage::ReceivedMessage( const ReceivedPacket& packet, const char*& error )
+    : addressPattern_( packet.Contents() )
+{
+    error = Init( packet.Contents(), packet.Size() );
+    if( error )
+        Clear();
+}
+
+
+ReceivedMessage::ReceivedMessage( const ReceivedBundleElement& bundleElement, const char*& error )
+    : addressPattern_( bundleElement.Contents() )
+{
+    error = Init( bundleElement.Contents(), bundleElement.Size() );
+    if( error )
+        Clear();
+}
+
+
+void ReceivedMessage::Clear()
+{
+    addressPattern_ = "";
+    typeTagsBegin_ = 0;
+    typeTagsEnd_ = 0;
+    arguments_ = 0;
 }
 
 
@@ -582,23 +629,23 @@ uint32 ReceivedMessage::AddressPatternAsUInt32() const
 }
 
 
-void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size )
+const char* ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size )
 {
     if( !IsValidElementSizeValue(size) )
-        throw MalformedMessageException( "invalid message size" );
+        return "invalid message size";
 
     if( size == 0 )
-        throw MalformedMessageException( "zero length messages not permitted" );
+        return "zero length messages not permitted";
 
     if( !IsMultipleOf4(size) )
-        throw MalformedMessageException( "message size must be multiple of four" );
+        return "message size must be multiple of four";
 
     const char *end = message + size;
 
     typeTagsBegin_ = FindStr4End( addressPattern_, end );
     if( typeTagsBegin_ == 0 ){
         // address pattern was not terminated before end
-        throw MalformedMessageException( "unterminated address pattern" );
+        return "unterminated address pattern";
     }
 
     if( typeTagsBegin_ == end ){
@@ -609,7 +656,7 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
             
     }else{
         if( *typeTagsBegin_ != ',' )
-            throw MalformedMessageException( "type tags not present" );
+            return "type tags not present";
 
         if( *(typeTagsBegin_ + 1) == '\0' ){
             // zero length type tags
@@ -622,7 +669,7 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
                 
             arguments_ = FindStr4End( typeTagsBegin_, end );
             if( arguments_ == 0 ){
-                throw MalformedMessageException( "type tags were not terminated before end of message" );
+                return "type tags were not terminated before end of message";
             }
 
             ++typeTagsBegin_; // advance past initial ','
@@ -660,10 +707,10 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
                     case MIDI_MESSAGE_TYPE_TAG:
 
                         if( argument == end )
-                            throw MalformedMessageException( "arguments exceed message size" );
+                            return "arguments exceed message size";
                         argument += 4;
                         if( argument > end )
-                            throw MalformedMessageException( "arguments exceed message size" );
+                            return "arguments exceed message size";
                         break;
 
                     case INT64_TYPE_TAG:
@@ -671,44 +718,45 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
                     case DOUBLE_TYPE_TAG:
 
                         if( argument == end )
-                            throw MalformedMessageException( "arguments exceed message size" );
+                            return "arguments exceed message size";
                         argument += 8;
                         if( argument > end )
-                            throw MalformedMessageException( "arguments exceed message size" );
+                            return "arguments exceed message size";
                         break;
 
                     case STRING_TYPE_TAG: 
                     case SYMBOL_TYPE_TAG:
                     
                         if( argument == end )
-                            throw MalformedMessageException( "arguments exceed message size" );
+                            return "arguments exceed message size";
                         argument = FindStr4End( argument, end );
                         if( argument == 0 )
-                            throw MalformedMessageException( "unterminated string argument" );
+                            return "unterminated string argument";
                         break;
 
                     case BLOB_TYPE_TAG:
                         {
                             if( argument + osc::OSC_SIZEOF_INT32 > end )
-                                MalformedMessageException( "arguments exceed message size" );
+                                return "arguments exceed message size";
                                 
                             // treat blob size as an unsigned int for the purposes of this calculation
                             uint32 blobSize = ToUInt32( argument );
-                            argument = argument + osc::OSC_SIZEOF_INT32 + RoundUp4( blobSize );
-                            if( argument > end )
-                                MalformedMessageException( "arguments exceed message size" );
+                            argument += osc::OSC_SIZEOF_INT32;
+                            if( blobSize > (uint32)(end - argument) )
+                                return "arguments exceed message size";
+                            argument += RoundUp4( blobSize );
                         }
                         break;
                         
                     default:
-                        throw MalformedMessageException( "unknown type tag" );
+                        return "unknown type tag";
                 }
 
             }while( *++typeTag != '\0' );
             typeTagsEnd_ = typeTag;
 
             if( arrayLevel !=  0 )
-                throw MalformedMessageException( "array was not terminated before end of message (expected ']' end of array tag)" );
+                return "array was not terminated before end of message (expected ']' end of array tag)";
         }
 
         // These invariants should be guaranteed by the above code.
@@ -719,6 +767,8 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
         assert( argumentCount <= OSC_INT32_MAX );
 #endif
     }
+
+    return 0;
 }
 
 //------------------------------------------------------------------------------
@@ -726,28 +776,61 @@ void ReceivedMessage::Init( const char *message, osc_bundle_element_size_t size
 ReceivedBundle::ReceivedBundle( const ReceivedPacket& packet )
     : elementCount_( 0 )
 {
-    Init( packet.Contents(), packet.Size() );
+    const char *error = Init( packet.Contents(), packet.Size() );
+    if( error )
+        throw MalformedBundleException( error );
 }
 
 
 ReceivedBundle::ReceivedBundle( const ReceivedBundleElement& bundleElement )
     : elementCount_( 0 )
 {
-    Init( bundleElement.Contents(), bundleElement.Size() );
+    const char *error = Init( bundleElement.Contents(), bundleElement.Size() );
+    if( error )
+        throw MalformedBundleException( error );
 }
 
 
-void ReceivedBundle::Init( const char *bundle, osc_bundle_element_size_t size )
+ReceivedBundle::ReceivedBundle( const ReceivedPacket& packet, const char*& error )
+    : elementCount_( 0 )
+{
+    error = Init( packet.Contents(), packet.Size() );
+    if( error )
+        Clear();
+}
+
+
+ReceivedBundle::ReceivedBundle( const ReceivedBundleElement& bundleElement, const char*& error )
+    : elementCount_( 0 )
+{
+    error = Init( bundleElement.Contents(), bundleElement.Size() );
+    if( error )
+        Clear();
+}
+
+
+void ReceivedBundle::Clear()
+{
+    // an "immediately" time tag and no elements
+    static const char emptyBundle[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+    timeTag_ = emptyBundle;
+    end_ = emptyBundle + 8;
+    elementCount_ = 0;
+}
+
+
+const char* ReceivedBundle::Init( const char *bundle, osc_bundle_element_size_t size )
 {
 
     if( !IsValidElementSizeValue(size) )
-        throw MalformedBundleException( "invalid bundle size" );
+        return "invalid bundle size";
 
     if( size < 16 )
-        throw MalformedBundleException( "packet too short for bundle" );
+        return "packet too short for bundle";
 
     if( !IsMultipleOf4(size) )
-        throw MalformedBundleException( "bundle size must be multiple of four" );
+        return "bundle size must be multiple of four";
 
     if( bundle[0] != '#'
         || bundle[1] != 'b'
@@ -757,7 +840,7 @@ void ReceivedBundle::Init( const char *bundle, osc_bundle_element_size_t size )
         || bundle[5] != 'l'
         || bundle[6] != 'e'
         || bundle[7] != '\0' )
-            throw MalformedBundleException( "bad bundle address pattern" );    
+            return "bad bundle address pattern";    
 
     end_ = bundle + size;
 
@@ -767,22 +850,24 @@ void ReceivedBundle::Init( const char *bundle, osc_bundle_element_size_t size )
         
     while( p < end_ ){
         if( p + osc::OSC_SIZEOF_INT32 > end_ )
-            throw MalformedBundleException( "packet too short for elementSize" );
+            return "packet too short for elementSize";
 
         // treat element size as an unsigned int for the purposes of this calculation
         uint32 elementSize = ToUInt32( p );
         if( (elementSize & ((uint32)0x03)) != 0 )
-            throw MalformedBundleException( "bundle element size must be multiple of four" );
+            return "bundle element size must be multiple of four";
 
         p += osc::OSC_SIZEOF_INT32 + elementSize;
         if( p > end_ )
-            throw MalformedBundleException( "packet too short for bundle element" );
+            return "packet too short for bundle element";
 
         ++elementCount_;
     }
 
     if( p != end_ )
-        throw MalformedBundleException( "bundle contents " );
+        return "bundle contents ";
+
+    return 0;
 }
 
 
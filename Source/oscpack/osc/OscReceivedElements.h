@@ -106,6 +106,32 @@ public:
         , size_( ValidateSize( (osc_bundle_element_size_t)size ) ) {}
 #endif
 
+    // non-throwing version: sets error to a description of the problem (and
+    // the size to 0) if the size is invalid, or to 0 if it is valid
+    ReceivedPacket( const char *contents, osc_bundle_element_size_t size, const char*& error )
+        : contents_( contents )
+        , size_( 0 )
+    {
+        error = CheckSize( size );
+        if( !error )
+            size_ = size;
+    }
+
+    // returns 0 if size is a valid packet size, otherwise a description of the problem
+    static const char* CheckSize( osc_bundle_element_size_t size )
+    {
+        if( !IsValidElementSizeValue(size) )
+            return "invalid packet size";
+
+        if( size == 0 )
+            return "zero length elements not permitted";
+
+        if( !IsMultipleOf4(size) )
+            return "element size must be multiple of four";
+
+        return 0;
+    }
+
     bool IsMessage() const { return !IsBundle(); }
     bool IsBundle() const;
 
@@ -125,14 +151,9 @@ private:
         assert( sizeof(osc::int64) == 8 );
         assert( sizeof(osc::uint64) == 8 );
 
-        if( !IsValidElementSizeValue(size) )
-            throw MalformedPacketException( "invalid packet size" );
-
-        if( size == 0 )
-            throw MalformedPacketException( "zero length elements not permitted" );
-
-        if( !IsMultipleOf4(size) )
-            throw MalformedPacketException( "element size must be multiple of four" );
+        const char *error = CheckSize( size );
+        if( error )
+            throw MalformedPacketException( error );
 
         return size;
     }
@@ -272,6 +293,27 @@ public:
     void AsBlob( const void*& data, osc_bundle_element_size_t& size ) const;
     void AsBlobUnchecked( const void*& data, osc_bundle_element_size_t& size ) const;
     
+    // non-throwing accessors: return false, leaving value untouched, if the
+    // argument is missing or of another type
+
+    bool TryAsBool( bool& value ) const
+        { if( !typeTagPtr_ || !IsBool() ) return false; value = AsBoolUnchecked(); return true; }
+    bool TryAsInt32( int32& value ) const
+        { if( !typeTagPtr_ || !IsInt32() ) return false; value = AsInt32Unchecked(); return true; }
+    bool TryAsFloat( float& value ) const
+        { if( !typeTagPtr_ || !IsFloat() ) return false; value = AsFloatUnchecked(); return true; }
+    bool TryAsInt64( int64& value ) const
+        { if( !typeTagPtr_ || !IsInt64() ) return false; value = AsInt64Unchecked(); return true; }
+    bool TryAsTimeTag( uint64& value ) const
+        { if( !typeTagPtr_ || !IsTimeTag() ) return false; value = AsTimeTagUnchecked(); return true; }
+    bool TryAsDouble( double& value ) const
+        { if( !typeTagPtr_ || !IsDouble() ) return false; value = AsDoubleUnchecked(); return true; }
+    bool TryAsString( const char*& value ) const
+        { if( !typeTagPtr_ || !IsString() ) return false; value = AsStringUnchecked(); return true; }
+    bool TryAsSymbol( const char*& value ) const
+        { if( !typeTagPtr_ || !IsSymbol() ) return false; value = AsSymbolUnchecked(); return true; }
+    bool TryAsBlob( const void*& data, osc_bundle_element_size_t& size ) const;
+
     bool IsArrayBegin() const { return *typeTagPtr_ == ARRAY_BEGIN_TYPE_TAG; }
     bool IsArrayEnd() const { return *typeTagPtr_ == ARRAY_END_TYPE_TAG; }
     // Calculate the number of top-level items in the array. Nested arrays count as one item.
@@ -347,6 +389,25 @@ public:
     // end of stream
     bool Eos() const { return p_ == end_; }
 
+    // non-throwing extraction: returns false without advancing if the stream
+    // is at its end or the next argument is of another type
+    bool TryGet( bool& rhs ) { return !Eos() && p_->TryAsBool( rhs ) && Skip(); }
+    bool TryGet( int32& rhs ) { return !Eos() && p_->TryAsInt32( rhs ) && Skip(); }
+    bool TryGet( float& rhs ) { return !Eos() && p_->TryAsFloat( rhs ) && Skip(); }
+    bool TryGet( int64& rhs ) { return !Eos() && p_->TryAsInt64( rhs ) && Skip(); }
+    bool TryGet( double& rhs ) { return !Eos() && p_->TryAsDouble( rhs ) && Skip(); }
+    bool TryGet( const char*& rhs ) { return !Eos() && p_->TryAsString( rhs ) && Skip(); }
+    bool TryGet( Blob& rhs ) { return !Eos() && p_->TryAsBlob( rhs.data, rhs.size ) && Skip(); }
+
+    // advances past the next argument, returns false at the end of the stream
+    bool Skip()
+    {
+        if( Eos() )
+            return false;
+        ++p_;
+        return true;
+    }
+
     ReceivedMessageArgumentStream& operator>>( bool& rhs )
     {
         if( Eos() )
@@ -472,11 +533,24 @@ public:
 
 
 class ReceivedMessage{
-    void Init( const char *bundle, osc_bundle_element_size_t size );
+    // returns 0 if the message is well formed, otherwise a description of the problem
+    const char* Init( const char *bundle, osc_bundle_element_size_t size );
+    void Clear();
 public:
+    // an empty message (no address, no arguments), so messages can be
+    // stored in preallocated arrays and assigned later
+    ReceivedMessage() { Clear(); }
+
+    // throw MalformedMessageException if the message is malformed
     explicit ReceivedMessage( const ReceivedPacket& packet );
     explicit ReceivedMessage( const ReceivedBundleElement& bundleElement );
 
+    // non-throwing versions: error is set to 0 if the message is well formed,
+    // otherwise to a description of the problem, and the message is left
+    // with an empty address pattern and no arguments
+    ReceivedMessage( const ReceivedPacket& packet, const char*& error );
+    ReceivedMessage( const ReceivedBundleElement& bundleElement, const char*& error );
+
 	const char *AddressPattern() const { return addressPattern_; }
 
 	// Support for non-standard SuperCollider integer address patterns:
@@ -487,6 +561,9 @@ public:
 
     const char *TypeTags() const { return typeTagsBegin_; }
 
+    // start of the argument data, laid out in type tag order
+    const char *ArgumentData() const { return arguments_; }
+
 
     typedef ReceivedMessageArgumentIterator const_iterator;
     
@@ -514,11 +591,20 @@ private:
 
 
 class ReceivedBundle{
-    void Init( const char *message, osc_bundle_element_size_t size );
+    // returns 0 if the bundle is well formed, otherwise a description of the problem
+    const char* Init( const char *message, osc_bundle_element_size_t size );
+    void Clear();
 public:
+    // throw MalformedBundleException if the bundle is malformed
     explicit ReceivedBundle( const ReceivedPacket& packet );
     explicit ReceivedBundle( const ReceivedBundleElement& bundleElement );
 
+    // non-throwing versions: error is set to 0 if the bundle is well formed,
+    // otherwise to a description of the problem, and the bundle is left
+    // with no elements
+    ReceivedBundle( const ReceivedPacket& packet, const char*& error );
+    ReceivedBundle( const ReceivedBundleElement& bundleElement, const char*& error );
+
     uint64 TimeTag() const;
 
     uint32 ElementCount() const { return elementCount_; }
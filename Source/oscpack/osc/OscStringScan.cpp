@@ -0,0 +1,252 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "OscStringScan.h"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_STRING_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define OSC_AVX2_TARGET
+#else
+#define OSC_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OSC_STRING_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace osc{
+
+namespace{
+
+inline int CountTrailingZeros( uint64_t x )
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64( &index, x );
+    return (int)index;
+#else
+    return __builtin_ctzll( x );
+#endif
+}
+
+} // namespace
+
+
+const char* FindStr4EndScalar( const char *p, const char *end )
+{
+    if( p >= end )
+        return 0;
+
+    p += 3;
+    end -= 1;
+
+    while( p < end && *p )
+        p += 4;
+
+    if( *p )
+        return 0;
+    else
+        return p + 1;
+}
+
+
+#ifdef OSC_STRING_SCAN_X86
+
+static const char* FindStr4EndSse2( const char *p, const char *end )
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    while( end - p >= 16 ){
+        __m128i bytes = _mm_loadu_si128( (const __m128i*)p );
+
+        // only the last byte of each 4 byte word decides where a str4 ends
+        unsigned int mask = (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( bytes, zero ) ) & 0x8888u;
+
+        if( mask )
+            return p + CountTrailingZeros( mask ) + 1;
+
+        p += 16;
+    }
+
+    return FindStr4EndScalar( p, end );
+}
+
+OSC_AVX2_TARGET
+static const char* FindStr4EndAvx2( const char *p, const char *end )
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    while( end - p >= 32 ){
+        __m256i bytes = _mm256_loadu_si256( (const __m256i*)p );
+
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8( _mm256_cmpeq_epi8( bytes, zero ) ) & 0x88888888u;
+
+        if( mask )
+            return p + CountTrailingZeros( mask ) + 1;
+
+        p += 32;
+    }
+
+    return FindStr4EndSse2( p, end );
+}
+
+static bool CpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid( info, 0 );
+    if( info[0] < 7 )
+        return false;
+
+    __cpuid( info, 1 );
+    bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv( 0 ) & 0x6) == 0x6);
+
+    __cpuidex( info, 7, 0 );
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+
+#endif /* OSC_STRING_SCAN_X86 */
+
+
+#ifdef OSC_STRING_SCAN_NEON
+
+static const char* FindStr4EndNeon( const char *p, const char *end )
+{
+    const uint8x16_t zero = vdupq_n_u8( 0 );
+
+    while( end - p >= 16 ){
+        uint8x16_t equal = vceqq_u8( vld1q_u8( (const uint8_t*)p ), zero );
+
+        // narrow to 4 bits per byte, then keep the nibbles of each word's last byte
+        uint64_t mask = vget_lane_u64( vreinterpret_u64_u8(
+                vshrn_n_u16( vreinterpretq_u16_u8( equal ), 4 ) ), 0 ) & 0xF000F000F000F000ULL;
+
+        if( mask )
+            return p + (CountTrailingZeros( mask ) >> 2) + 1;
+
+        p += 16;
+    }
+
+    return FindStr4EndScalar( p, end );
+}
+
+#endif /* OSC_STRING_SCAN_NEON */
+
+
+bool IsStringScanKernelAvailable( StringScanKernel kernel )
+{
+    switch( kernel ){
+        case SCALAR_STRING_SCAN:
+            return true;
+#ifdef OSC_STRING_SCAN_X86
+        case SSE2_STRING_SCAN:
+            return true;
+        case AVX2_STRING_SCAN:
+            return CpuSupportsAvx2();
+#endif
+#ifdef OSC_STRING_SCAN_NEON
+        case NEON_STRING_SCAN:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+
+static StringScanKernel SelectStringScanKernel()
+{
+    if( IsStringScanKernelAvailable( AVX2_STRING_SCAN ) )
+        return AVX2_STRING_SCAN;
+    if( IsStringScanKernelAvailable( SSE2_STRING_SCAN ) )
+        return SSE2_STRING_SCAN;
+    if( IsStringScanKernelAvailable( NEON_STRING_SCAN ) )
+        return NEON_STRING_SCAN;
+    return SCALAR_STRING_SCAN;
+}
+
+typedef const char* (*FindStr4EndFunction)( const char *p, const char *end );
+
+static FindStr4EndFunction FindStr4EndFunctionFor( StringScanKernel kernel )
+{
+    switch( kernel ){
+#ifdef OSC_STRING_SCAN_X86
+        case AVX2_STRING_SCAN:
+            return FindStr4EndAvx2;
+        case SSE2_STRING_SCAN:
+            return FindStr4EndSse2;
+#endif
+#ifdef OSC_STRING_SCAN_NEON
+        case NEON_STRING_SCAN:
+            return FindStr4EndNeon;
+#endif
+        default:
+            return FindStr4EndScalar;
+    }
+}
+
+static StringScanKernel selectedKernel_ = SelectStringScanKernel();
+static FindStr4EndFunction findStr4End_ = FindStr4EndFunctionFor( selectedKernel_ );
+
+
+StringScanKernel SelectedStringScanKernel()
+{
+    return selectedKernel_;
+}
+
+
+bool SetStringScanKernel( StringScanKernel kernel )
+{
+    if( !IsStringScanKernelAvailable( kernel ) )
+        return false;
+
+    selectedKernel_ = kernel;
+    findStr4End_ = FindStr4EndFunctionFor( kernel );
+    return true;
+}
+
+
+const char* FindStr4EndWithKernel( StringScanKernel kernel, const char *p, const char *end )
+{
+    return FindStr4EndFunctionFor( kernel )( p, end );
+}
+
+
+const char* FindStr4EndBounded( const char *p, const char *end )
+{
+    return findStr4End_( p, end );
+}
+
+} // namespace osc
@@ -0,0 +1,70 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INCLUDED_OSCPACK_OSCSTRINGSCAN_H
+#define INCLUDED_OSCPACK_OSCSTRINGSCAN_H
+
+/*
+    Kernels that find the end of an OSC string (NUL terminated, padded with
+    NULs to a multiple of 4 bytes) inside a packet.
+
+    All of them look at the last byte of every 4 byte word starting at p,
+    and return the address after the first word whose last byte is NUL,
+    or 0 if there is none before end. p and end must be 4 byte aligned
+    relative to each other (end - p is a multiple of 4), which holds for
+    every OSC packet.
+
+    The SIMD kernels compare 16 (SSE2, NEON) or 32 (AVX2) bytes per step
+    and never read past end. FindStr4EndBounded() uses the widest kernel
+    supported by the running CPU, chosen once at startup.
+*/
+
+namespace osc{
+
+enum StringScanKernel{
+    SCALAR_STRING_SCAN,
+    SSE2_STRING_SCAN,
+    AVX2_STRING_SCAN,
+    NEON_STRING_SCAN
+};
+
+const char* FindStr4EndScalar( const char *p, const char *end );
+
+// true if the kernel is compiled in and supported by the running CPU
+bool IsStringScanKernelAvailable( StringScanKernel kernel );
+
+// scans with a specific kernel, which must be available
+const char* FindStr4EndWithKernel( StringScanKernel kernel, const char *p, const char *end );
+
+// the kernel used by FindStr4EndBounded()
+StringScanKernel SelectedStringScanKernel();
+
+// overrides the kernel chosen at startup (for benchmarks), returns false if it is not available.
+// must not be called while packets are being parsed on other threads
+bool SetStringScanKernel( StringScanKernel kernel );
+
+// dispatches to the fastest available kernel
+const char* FindStr4EndBounded( const char *p, const char *end );
+
+} // namespace osc
+
+#endif /* INCLUDED_OSCPACK_OSCSTRINGSCAN_H */
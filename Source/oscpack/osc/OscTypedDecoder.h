@@ -0,0 +1,199 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INCLUDED_OSCPACK_OSCTYPEDDECODER_H
+#define INCLUDED_OSCPACK_OSCTYPEDDECODER_H
+
+#include <cstring>
+
+#include "OscReceivedElements.h"
+
+/*
+    Decodes message arguments against a signature fixed at compile time:
+
+        osc::int32 line;
+        bool state;
+
+        if( osc::DecodeArguments( message, line, state ) )    // ",iT" or ",iF"
+            ...
+
+    The type tags are checked against the whole signature up front, then
+    the arguments are read with the unchecked accessors. For fixed size
+    types the argument offsets are compile-time constants. Nothing throws:
+    a message that does not match the signature leaves the values untouched
+    and returns false.
+
+    Supported types: bool (T or F), int32, float, char, int64, double,
+    TimeTag, const char* (string), Symbol and Blob.
+*/
+
+namespace osc{
+
+template< typename T > struct ArgumentTraits;
+
+// fixed size arguments, SIZE bytes of argument data
+
+template<> struct ArgumentTraits< bool >{
+    enum { SIZE = 0 };
+    static bool Matches( char tag ) { return tag == TRUE_TYPE_TAG || tag == FALSE_TYPE_TAG; }
+    static bool Read( const ReceivedMessageArgument& a ) { return a.AsBoolUnchecked(); }
+};
+
+template<> struct ArgumentTraits< int32 >{
+    enum { SIZE = 4 };
+    static bool Matches( char tag ) { return tag == INT32_TYPE_TAG; }
+    static int32 Read( const ReceivedMessageArgument& a ) { return a.AsInt32Unchecked(); }
+};
+
+template<> struct ArgumentTraits< float >{
+    enum { SIZE = 4 };
+    static bool Matches( char tag ) { return tag == FLOAT_TYPE_TAG; }
+    static float Read( const ReceivedMessageArgument& a ) { return a.AsFloatUnchecked(); }
+};
+
+template<> struct ArgumentTraits< char >{
+    enum { SIZE = 4 };
+    static bool Matches( char tag ) { return tag == CHAR_TYPE_TAG; }
+    static char Read( const ReceivedMessageArgument& a ) { return a.AsCharUnchecked(); }
+};
+
+template<> struct ArgumentTraits< int64 >{
+    enum { SIZE = 8 };
+    static bool Matches( char tag ) { return tag == INT64_TYPE_TAG; }
+    static int64 Read( const ReceivedMessageArgument& a ) { return a.AsInt64Unchecked(); }
+};
+
+template<> struct ArgumentTraits< double >{
+    enum { SIZE = 8 };
+    static bool Matches( char tag ) { return tag == DOUBLE_TYPE_TAG; }
+    static double Read( const ReceivedMessageArgument& a ) { return a.AsDoubleUnchecked(); }
+};
+
+template<> struct ArgumentTraits< TimeTag >{
+    enum { SIZE = 8 };
+    static bool Matches( char tag ) { return tag == TIME_TAG_TYPE_TAG; }
+    static TimeTag Read( const ReceivedMessageArgument& a ) { return TimeTag( a.AsTimeTagUnchecked() ); }
+};
+
+// variable size arguments (SIZE -1), measured while reading
+
+template<> struct ArgumentTraits< const char* >{
+    enum { SIZE = -1 };
+    static bool Matches( char tag ) { return tag == STRING_TYPE_TAG; }
+    static const char* Read( const ReceivedMessageArgument& a ) { return a.AsStringUnchecked(); }
+    static std::size_t DataSize( const char *argument ) { return (std::strlen( argument ) + 4) & ~((std::size_t)3); }
+};
+
+template<> struct ArgumentTraits< Symbol >{
+    enum { SIZE = -1 };
+    static bool Matches( char tag ) { return tag == SYMBOL_TYPE_TAG; }
+    static Symbol Read( const ReceivedMessageArgument& a ) { return Symbol( a.AsSymbolUnchecked() ); }
+    static std::size_t DataSize( const char *argument ) { return (std::strlen( argument ) + 4) & ~((std::size_t)3); }
+};
+
+template<> struct ArgumentTraits< Blob >{
+    enum { SIZE = -1 };
+    static bool Matches( char tag ) { return tag == BLOB_TYPE_TAG; }
+    static Blob Read( const ReceivedMessageArgument& a )
+    {
+        Blob blob;
+        a.AsBlobUnchecked( blob.data, blob.size );
+        return blob;
+    }
+    static std::size_t DataSize( const char *argument )
+    {
+        // already validated by ReceivedMessage::Init()
+        uint32 size = ReceivedMessageArgument( "b", argument ).AsInt32Unchecked();
+        return 4 + ((size + 3) & ~((uint32)3));
+    }
+};
+
+
+namespace detail{
+
+template< typename T, int Size = ArgumentTraits< T >::SIZE >
+struct ArgumentDataSize{
+    static std::size_t Get( const char * ) { return (std::size_t)Size; }
+};
+
+template< typename T >
+struct ArgumentDataSize< T, -1 >{
+    static std::size_t Get( const char *argument ) { return ArgumentTraits< T >::DataSize( argument ); }
+};
+
+inline bool TypeTagsMatch( const char * ) { return true; }
+
+template< typename T, typename... Rest >
+inline bool TypeTagsMatch( const char *typeTags, const T&, const Rest&... rest )
+{
+    return ArgumentTraits< T >::Matches( *typeTags ) && TypeTagsMatch( typeTags + 1, rest... );
+}
+
+inline void ReadArguments( const char *, const char * ) {}
+
+template< typename T, typename... Rest >
+inline void ReadArguments( const char *typeTag, const char *argument, T& value, Rest&... rest )
+{
+    value = ArgumentTraits< T >::Read( ReceivedMessageArgument( typeTag, argument ) );
+    ReadArguments( typeTag + 1, argument + ArgumentDataSize< T >::Get( argument ), rest... );
+}
+
+template< typename... Ts >
+inline bool DecodeArguments( const ReceivedMessage& m, bool allowExtraArguments, Ts&... values )
+{
+    const uint32 count = m.ArgumentCount();
+
+    if( allowExtraArguments ? count < sizeof...(Ts) : count != sizeof...(Ts) )
+        return false;
+
+    if( sizeof...(Ts) == 0 )
+        return true;
+
+    const char *typeTags = m.TypeTags();
+
+    if( !TypeTagsMatch( typeTags, values... ) )
+        return false;
+
+    ReadArguments( typeTags, m.ArgumentData(), values... );
+    return true;
+}
+
+} // namespace detail
+
+
+// decodes a message whose arguments are exactly of the types of values
+template< typename... Ts >
+inline bool DecodeArguments( const ReceivedMessage& m, Ts&... values )
+{
+    return detail::DecodeArguments( m, false, values... );
+}
+
+// decodes the leading arguments of a message, further arguments are ignored
+template< typename... Ts >
+inline bool DecodeLeadingArguments( const ReceivedMessage& m, Ts&... values )
+{
+    return detail::DecodeArguments( m, true, values... );
+}
+
+} // namespace osc
+
+#endif /* INCLUDED_OSCPACK_OSCTYPEDDECODER_H */
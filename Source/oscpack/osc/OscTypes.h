@@ -224,6 +224,24 @@ struct Blob{
     osc_bundle_element_size_t size;
 };
 
+// count float32 arguments, written in one step (see OutboundPacketStream)
+struct Float32Array{
+    Float32Array() {}
+    explicit Float32Array( const float* data_, osc_bundle_element_size_t count_ )
+            : data( data_ ), count( count_ ) {}
+    const float* data;
+    osc_bundle_element_size_t count;
+};
+
+// a blob holding count float32 values in OSC (big-endian) byte order
+struct Float32Blob{
+    Float32Blob() {}
+    explicit Float32Blob( const float* data_, osc_bundle_element_size_t count_ )
+            : data( data_ ), count( count_ ) {}
+    const float* data;
+    osc_bundle_element_size_t count;
+};
+
 struct ArrayInitiator{
 };
 
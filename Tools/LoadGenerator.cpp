@@ -0,0 +1,397 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	OSC traffic generator for stress-testing the OSC Events listener.
+
+	Every message is <address> <int32 line> <int32 state> <int32 sequence>
+	<int64 send time> followed by optional random arguments. The plugin only
+	reads line and state, so the extra arguments are ignored by it but let
+	a listener measure loss, reordering and latency. The send time is in
+	nanoseconds of the packet clock used for kernel arrival timestamps
+	(CLOCK_REALTIME).
+
+	Options:
+		--host H          destination host (127.0.0.1)
+		--port P          destination port (5005)
+		--address A       OSC address (/ttl)
+		--rate R          packets per second, 0 for as fast as possible (1000)
+		--count N         packets to send, 0 for unlimited (10000)
+		--duration S      stop after S seconds (unlimited)
+		--burst N         packets sent back to back per burst, bursts are paced to keep the rate (1)
+		--bundle N        messages per packet, sent as a bundle when N > 1 (1)
+		--ahead-ms T      send bundles (even of one message) time-tagged T ms in the future (off)
+		--lines N         cycle through TTL lines 0 .. N-1 (8)
+		--pulse           always send state 1 instead of alternating on/off
+		--random-args N   append up to N random arguments of mixed types (0)
+		--seed S          random seed (1)
+		--query           send no traffic, print the plugin's receive stats instead
+*/
+
+#include <oscpack/ip/PacketListener.h>
+#include <oscpack/ip/TimerListener.h>
+#include <oscpack/ip/UdpSocket.h>
+#include <oscpack/osc/OscOutboundPacketStream.h>
+#include <oscpack/osc/OscReceivedElements.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+// largest UDP payload over IPv4
+const int PACKET_BUFFER_SIZE = 65507;
+
+struct Options
+{
+	std::string host = "127.0.0.1";
+	int port = 5005;
+	std::string address = "/ttl";
+	double rate = 1000;
+	long count = 10000;
+	double duration = 0;
+	int burst = 1;
+	int bundle = 1;
+	double aheadMs = -1;
+	int lines = 8;
+	bool pulse = false;
+	int randomArgs = 0;
+	unsigned seed = 1;
+	bool query = false;
+};
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* name = argv[i];
+
+		if (std::strcmp(name, "--pulse") == 0)
+		{
+			options.pulse = true;
+			continue;
+		}
+
+		if (std::strcmp(name, "--query") == 0)
+		{
+			options.query = true;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "missing value for %s\n", name);
+			return false;
+		}
+
+		const char* value = argv[++i];
+
+		if (std::strcmp(name, "--host") == 0)
+			options.host = value;
+		else if (std::strcmp(name, "--port") == 0)
+			options.port = std::atoi(value);
+		else if (std::strcmp(name, "--address") == 0)
+			options.address = value;
+		else if (std::strcmp(name, "--rate") == 0)
+			options.rate = std::atof(value);
+		else if (std::strcmp(name, "--count") == 0)
+			options.count = std::atol(value);
+		else if (std::strcmp(name, "--duration") == 0)
+			options.duration = std::atof(value);
+		else if (std::strcmp(name, "--burst") == 0)
+			options.burst = std::max(1, std::atoi(value));
+		else if (std::strcmp(name, "--bundle") == 0)
+			options.bundle = std::max(1, std::atoi(value));
+		else if (std::strcmp(name, "--ahead-ms") == 0)
+			options.aheadMs = std::atof(value);
+		else if (std::strcmp(name, "--lines") == 0)
+			options.lines = std::max(1, std::atoi(value));
+		else if (std::strcmp(name, "--random-args") == 0)
+			options.randomArgs = std::max(0, std::atoi(value));
+		else if (std::strcmp(name, "--seed") == 0)
+			options.seed = (unsigned) std::atol(value);
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", name);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Appends one argument of a random OSC type */
+void appendRandomArgument(osc::OutboundPacketStream& packet, std::mt19937& random)
+{
+	static const char* const words[] = { "alpha", "beta", "gamma", "delta-epsilon" };
+	static const char blob[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+	switch (random() % 8)
+	{
+	case 0: packet << (osc::int32) random(); break;
+	case 1: packet << float(random() % 100000) * 0.01f; break;
+	case 2: packet << words[random() % 4]; break;
+	case 3: packet << osc::Blob(blob, 1 + random() % sizeof(blob)); break;
+	case 4: packet << (osc::int64) random() * 4096; break;
+	case 5: packet << double(random()) * 1e-3; break;
+	case 6: packet << bool(random() & 1); break;
+	default: packet << osc::OscNil; break;
+	}
+}
+
+/** Converts a packet clock time (nanoseconds since the unix epoch) to an NTP time tag */
+osc::uint64 toTimeTag(unsigned long long timeNs)
+{
+	const osc::uint64 ntpUnixOffsetSeconds = 2208988800ULL;
+
+	osc::uint64 seconds = timeNs / 1000000000ULL + ntpUnixOffsetSeconds;
+	osc::uint64 fraction = ((timeNs % 1000000000ULL) << 32) / 1000000000ULL;
+
+	return (seconds << 32) | fraction;
+}
+
+/** STATS_QUERY_ADDRESS in OSCEvents.h */
+const char* const STATS_QUERY_ADDRESS = "/oscevents/stats";
+
+/** Prints the reply to a stats query, or gives up after the timer expires */
+class StatsReplyListener : public PacketListener, public TimerListener
+{
+public:
+	StatsReplyListener(SocketReceiveMultiplexer& multiplexer) : m_multiplexer(multiplexer) {}
+
+	void ProcessPacket(const char* data, int size, const IpEndpointName&) override
+	{
+		// reply arguments, in the order OSCServer::sendStats() writes them
+		static const char* const names[] = {
+			"packets received", "malformed packets", "messages received", "unmatched messages",
+			"messages queued", "queue drops", "queue depth", "messages processed",
+			"events emitted", "scheduler drops", "latency samples",
+			"latency p50 (us)", "latency p90 (us)", "latency p99 (us)", "latency p99.9 (us)", "latency max (us)",
+			"truncated packets", "payload drops"
+		};
+		// the latencies are arguments [firstLatency, firstLatency + 5), the rest are counters
+		const int firstLatency = 11;
+		const int numValues = 18;
+
+		const char* error = nullptr;
+		osc::ReceivedPacket packet(data, size, error);
+
+		if (error || !packet.IsMessage())
+			return;
+
+		osc::ReceivedMessage message(packet, error);
+
+		if (error || std::strcmp(message.AddressPattern(), STATS_QUERY_ADDRESS) != 0)
+			return;
+
+		int index = 0;
+
+		for (auto arg = message.ArgumentsBegin(); arg != message.ArgumentsEnd() && index < numValues; ++arg, ++index)
+		{
+			osc::int64 value = 0;
+			arg->TryAsInt64(value);
+
+			if (index < firstLatency || index >= firstLatency + 5)
+				std::printf("%-20s %lld\n", names[index], (long long) value);
+			else
+				std::printf("%-20s %.1f\n", names[index], value * 1e-3);
+		}
+
+		received = true;
+		m_multiplexer.Break();
+	}
+
+	void TimerExpired() override
+	{
+		m_multiplexer.Break();
+	}
+
+	bool received = false;
+
+private:
+	SocketReceiveMultiplexer& m_multiplexer;
+};
+
+/** Sends a stats query from the socket and prints the reply */
+int queryStats(UdpTransmitSocket& socket)
+{
+	char buffer[256];
+	osc::OutboundPacketStream packet(buffer, sizeof(buffer));
+	packet << osc::BeginMessage(STATS_QUERY_ADDRESS) << osc::EndMessage;
+
+	SocketReceiveMultiplexer multiplexer;
+	StatsReplyListener listener(multiplexer);
+
+	multiplexer.AttachSocketListener(&socket, &listener);
+	multiplexer.AttachPeriodicTimerListener(1000, &listener);
+
+	socket.Send(packet.Data(), packet.Size());
+	multiplexer.Run();
+
+	multiplexer.DetachPeriodicTimerListener(&listener);
+	multiplexer.DetachSocketListener(&socket, &listener);
+
+	if (!listener.received)
+	{
+		std::fprintf(stderr, "no reply to %s within 1 s\n", STATS_QUERY_ADDRESS);
+		return 1;
+	}
+
+	return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!parseOptions(argc, argv, options))
+		return 2;
+
+	std::unique_ptr<UdpTransmitSocket> socket;
+
+	try
+	{
+		socket = std::make_unique<UdpTransmitSocket>(IpEndpointName(options.host.c_str(), options.port));
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "unable to open socket: %s\n", e.what());
+		return 1;
+	}
+
+	if (options.query)
+		return queryStats(*socket);
+
+	std::mt19937 random(options.seed);
+	static char buffer[PACKET_BUFFER_SIZE];
+
+	std::printf("sending to %s:%d %s, rate %.0f/s, burst %d, bundle %d, random args %d\n",
+				options.host.c_str(), options.port, options.address.c_str(),
+				options.rate, options.burst, options.bundle, options.randomArgs);
+
+	typedef std::chrono::steady_clock Clock;
+
+	const Clock::time_point start = Clock::now();
+	const double burstInterval = options.rate > 0 ? options.burst / options.rate : 0.0;
+
+	long packets = 0;
+	long messages = 0;
+	long bytes = 0;
+	osc::uint32 sequence = 0;
+
+	for (long burst = 0; ; burst++)
+	{
+		if (burstInterval > 0)
+		{
+			const Clock::time_point due = start + std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<double>(burst * burstInterval));
+
+			// sleep for the coarse part of the wait, spin for the last 100 us
+			if (due - Clock::now() > std::chrono::microseconds(200))
+				std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+
+			while (Clock::now() < due)
+				;
+		}
+
+		double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+		if (options.duration > 0 && elapsed >= options.duration)
+			break;
+
+		bool done = false;
+
+		for (int b = 0; b < options.burst; b++)
+		{
+			if (options.count > 0 && packets >= options.count)
+			{
+				done = true;
+				break;
+			}
+
+			try
+			{
+				osc::OutboundPacketStream packet(buffer, PACKET_BUFFER_SIZE);
+
+				const bool isBundle = options.bundle > 1 || options.aheadMs >= 0;
+
+				if (options.aheadMs >= 0)
+					packet << osc::BeginBundle(toTimeTag(GetPacketClockNanoseconds()
+														 + (unsigned long long) (options.aheadMs * 1e6)));
+				else if (isBundle)
+					packet << osc::BeginBundleImmediate;
+
+				for (int m = 0; m < options.bundle; m++)
+				{
+					int line = sequence % options.lines;
+					int state = options.pulse ? 1 : (sequence / options.lines) % 2 == 0;
+
+					packet << osc::BeginMessage(options.address.c_str())
+						   << (osc::int32) line << (osc::int32) state
+						   << (osc::int32) sequence++ << (osc::int64) GetPacketClockNanoseconds();
+
+					int extra = options.randomArgs > 0 ? (int) (random() % (options.randomArgs + 1)) : 0;
+					for (int a = 0; a < extra; a++)
+						appendRandomArgument(packet, random);
+
+					packet << osc::EndMessage;
+					messages++;
+				}
+
+				if (isBundle)
+					packet << osc::EndBundle;
+
+				socket->Send(packet.Data(), packet.Size());
+
+				packets++;
+				bytes += (long) packet.Size();
+			}
+			catch (const osc::Exception& e)
+			{
+				// only happens when --bundle and --random-args do not fit in one datagram
+				std::fprintf(stderr, "unable to build packet: %s\n", e.what());
+				return 1;
+			}
+		}
+
+		if (done)
+			break;
+	}
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::printf("sent %ld packets (%ld messages, %ld bytes) in %.3f s: %.0f packets/s, %.0f messages/s, %.1f Mbit/s\n",
+				packets, messages, bytes, seconds,
+				packets / seconds, messages / seconds, bytes * 8e-6 / seconds);
+
+	return 0;
+}
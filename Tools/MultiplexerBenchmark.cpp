@@ -0,0 +1,311 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Compares the select() and epoll multiplexer backends with 1, 16 and 256
+	sockets bound on the loopback interface.
+
+	A sender thread keeps a bounded number of datagrams in flight (so the
+	kernel never drops any) and the listener thread's CPU time per datagram
+	is measured. Two traffic patterns are run for every socket count:
+	"all" spreads datagrams round-robin over every socket, "one" sends
+	everything to a single socket while the others stay idle.
+
+	A second table measures timer precision: 1, 64 and 1024 periodic
+	timers (periods of 1 to 10 ms) run on an otherwise idle multiplexer,
+	and the error of each interval between expiries is recorded.
+
+	Usage: multiplexer-benchmark [--packets N] [--batch N] [--base-port P]
+*/
+
+#include <oscpack/ip/UdpSocket.h>
+#include <oscpack/ip/PacketListener.h>
+#include <oscpack/ip/TimerListener.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const int IN_FLIGHT_WINDOW = 128;
+
+class CountingListener : public PacketListener
+{
+public:
+	void ProcessPacket(const char*, int, const IpEndpointName&) override
+	{
+		received.fetch_add(1, std::memory_order_release);
+	}
+
+	std::atomic<long> received { 0 };
+};
+
+double threadCpuSeconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct Result
+{
+	long sent;
+	long received;
+	double wallSeconds;
+	double cpuSeconds;
+};
+
+Result runOnce(SocketReceiveMultiplexer::Backend backend, int numSockets, bool allActive,
+			   long numPackets, int batchSize, int basePort)
+{
+	CountingListener listener;
+	SocketReceiveMultiplexer mux;
+	mux.SetBackend(backend);
+	mux.SetReceiveBatchSize(batchSize);
+
+	std::vector<std::unique_ptr<UdpReceiveSocket>> sockets;
+	std::vector<IpEndpointName> endpoints;
+
+	for (int i = 0; i < numSockets; i++)
+	{
+		IpEndpointName endpoint("127.0.0.1", basePort + i);
+		sockets.push_back(std::make_unique<UdpReceiveSocket>(endpoint));
+		mux.AttachSocketListener(sockets.back().get(), &listener);
+		endpoints.push_back(endpoint);
+	}
+
+	double cpuSeconds = 0;
+	std::thread receiver([&]()
+	{
+		double start = threadCpuSeconds();
+		mux.Run();
+		cpuSeconds = threadCpuSeconds() - start;
+	});
+
+	UdpSocket sender;
+	char payload[16] = "/bench\0\0,\0\0\0";
+
+	Result result;
+	result.sent = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < numPackets; i++)
+	{
+		auto waitStart = std::chrono::steady_clock::now();
+		bool timedOut = false;
+
+		while (result.sent - listener.received.load(std::memory_order_acquire) >= IN_FLIGHT_WINDOW)
+		{
+			if (std::chrono::steady_clock::now() - waitStart > std::chrono::seconds(1))
+			{
+				timedOut = true;
+				break;
+			}
+			std::this_thread::yield();
+		}
+
+		if (timedOut)
+			break;
+
+		const IpEndpointName& target = endpoints[allActive ? (i % numSockets) : 0];
+		sender.SendTo(target, payload, sizeof(payload));
+		result.sent++;
+	}
+
+	auto drainStart = std::chrono::steady_clock::now();
+	while (listener.received.load(std::memory_order_acquire) < result.sent
+		   && std::chrono::steady_clock::now() - drainStart < std::chrono::seconds(1))
+		std::this_thread::yield();
+
+	result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.received = listener.received.load();
+
+	mux.AsynchronousBreak();
+	receiver.join();
+	result.cpuSeconds = cpuSeconds;
+
+	for (auto& socket : sockets)
+		mux.DetachSocketListener(socket.get(), &listener);
+
+	return result;
+}
+
+/** Records the error of each interval between two expiries against the period */
+class IntervalListener : public TimerListener
+{
+public:
+	IntervalListener(int periodMs, std::vector<double>& errors)
+		: m_periodNs(periodMs * 1000000ULL), m_errors(errors) {}
+
+	void TimerExpired() override
+	{
+		unsigned long long now = GetMonotonicClockNanoseconds();
+
+		if (m_lastNs != 0)
+			m_errors.push_back(((double) (now - m_lastNs) - (double) m_periodNs) * 1e-3);
+
+		m_lastNs = now;
+	}
+
+private:
+	unsigned long long m_periodNs;
+	unsigned long long m_lastNs = 0;
+	std::vector<double>& m_errors;
+};
+
+/** Runs numTimers periodic timers for runMs, returns the sorted interval errors in microseconds */
+std::vector<double> runTimers(SocketReceiveMultiplexer::Backend backend, int numTimers, int runMs)
+{
+	SocketReceiveMultiplexer mux;
+	mux.SetBackend(backend);
+
+	std::vector<double> errors;
+	errors.reserve((std::size_t) numTimers * runMs + 1024);
+
+	std::vector<std::unique_ptr<IntervalListener>> listeners;
+
+	for (int i = 0; i < numTimers; i++)
+	{
+		int periodMs = 1 + i % 10;
+		listeners.push_back(std::make_unique<IntervalListener>(periodMs, errors));
+		mux.AttachPeriodicTimerListener(periodMs, listeners.back().get());
+	}
+
+	std::thread receiver([&]() { mux.Run(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(runMs));
+	mux.AsynchronousBreak();
+	receiver.join();
+
+	for (auto& listener : listeners)
+		mux.DetachPeriodicTimerListener(listener.get());
+
+	std::sort(errors.begin(), errors.end());
+	return errors;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	long numPackets = 200000;
+	int batchSize = 1;
+	int basePort = 47000;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--packets") == 0)
+			numPackets = std::atol(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--batch") == 0)
+			batchSize = std::atoi(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--base-port") == 0)
+			basePort = std::atoi(argv[i + 1]);
+	}
+
+	const int socketCounts[] = { 1, 16, 256 };
+
+	struct Backend { SocketReceiveMultiplexer::Backend id; const char* name; };
+	const Backend backends[] = {
+		{ SocketReceiveMultiplexer::SELECT_BACKEND, "select" },
+		{ SocketReceiveMultiplexer::EPOLL_BACKEND, "epoll" }
+	};
+
+	std::printf("packets per run: %ld, batch size: %d\n\n", numPackets, batchSize);
+	std::printf("%-8s %8s %8s %10s %10s %12s %14s\n",
+				"backend", "sockets", "traffic", "received", "wall ms", "packets/s", "cpu ns/packet");
+
+	for (const Backend& backend : backends)
+	{
+		{
+			SocketReceiveMultiplexer probe;
+			probe.SetBackend(backend.id);
+			if (probe.GetBackend() != backend.id)
+			{
+				std::printf("%-8s (not available on this platform)\n", backend.name);
+				continue;
+			}
+		}
+
+		for (int numSockets : socketCounts)
+		{
+			for (int allActive = 1; allActive >= 0; allActive--)
+			{
+				if (numSockets == 1 && !allActive)
+					continue;
+
+				Result r;
+				try
+				{
+					r = runOnce(backend.id, numSockets, allActive != 0, numPackets, batchSize, basePort);
+				}
+				catch (const std::exception& e)
+				{
+					std::printf("%-8s %8d failed: %s", backend.name, numSockets, e.what());
+					continue;
+				}
+
+				std::printf("%-8s %8d %8s %10ld %10.1f %12.0f %14.0f\n",
+							backend.name, numSockets, allActive ? "all" : "one",
+							r.received, r.wallSeconds * 1e3,
+							r.received / r.wallSeconds,
+							r.received > 0 ? r.cpuSeconds * 1e9 / r.received : 0.0);
+			}
+		}
+	}
+
+	const int timerCounts[] = { 1, 64, 1024 };
+	const int timerRunMs = 1000;
+
+	std::printf("\ntimer interval error over %d ms (us, interval - period)\n", timerRunMs);
+	std::printf("%-8s %8s %10s %10s %10s %10s\n", "backend", "timers", "expiries", "p50", "p99", "max");
+
+	for (const Backend& backend : backends)
+	{
+		SocketReceiveMultiplexer probe;
+		probe.SetBackend(backend.id);
+		if (probe.GetBackend() != backend.id)
+			continue;
+
+		for (int numTimers : timerCounts)
+		{
+			std::vector<double> errors = runTimers(backend.id, numTimers, timerRunMs);
+
+			if (errors.empty())
+				continue;
+
+			std::printf("%-8s %8d %10zu %10.1f %10.1f %10.1f\n", backend.name, numTimers, errors.size(),
+						errors[errors.size() / 2], errors[errors.size() * 99 / 100], errors.back());
+		}
+	}
+
+	return 0;
+}
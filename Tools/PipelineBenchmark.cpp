@@ -0,0 +1,767 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Measures the OSC receive -> event pipeline without the GUI.
+
+	1. parse:    ReceivedPacket/ReceivedMessage construction and argument
+	             extraction through ReceivedMessageArgumentStream
+	   decode:   the same with the typed decoder (osc::DecodeArguments)
+	   malformed: rejecting truncated messages with the throwing and the
+	             non-throwing ReceivedMessage constructors
+	2. route:    address dispatch through OSCRouteTable
+	3. queue:    MessageQueue throughput between two threads
+	   slabs:    the same with packets copied into a PacketSlabPool and the
+	             messages handed over as views, decoded and released by the
+	             consumer
+	4. loopback: end-to-end latency of UDP datagrams sent over the loopback
+	             interface, received by the OSC listener, routed, queued and
+	             popped by a mock of the processor's process() loop
+	5. values:   OSCValueWriter filling 16 value channels at 30 kHz from
+	             1 kHz updates, held and linearly interpolated
+	   labels:   OSCLabelTable lookups of repeated text event labels, and
+	             scheduling them with TextEventScheduler
+	6. stream:   OSCStreamDecimator averaging 32 channels at 30 kHz into
+	             packets of 10 frames, packed as float arguments one at a
+	             time, as a Float32Array and as a Float32Blob, and checked
+	             by parsing the packets back
+
+	The mock processor either polls the queue continuously (yielding when it
+	is empty) or, with --block-us, wakes up once per simulated audio block
+	like the real process().
+
+	Usage: pipeline-benchmark [--iterations N] [--packets N] [--rate HZ]
+	                          [--block-us US] [--port P]
+*/
+
+#include <oscpack/ip/UdpSocket.h>
+#include <oscpack/osc/OscOutboundPacketStream.h>
+#include <oscpack/osc/OscPacketListener.h>
+#include <oscpack/osc/OscReceivedElements.h>
+#include <oscpack/osc/OscTypedDecoder.h>
+
+#include "LockFreeQueue.h"
+#include "OSCRouteTable.h"
+#include "OSCStats.h"
+#include "PacketSlabPool.h"
+#include "OSCValueWriter.h"
+#include "OSCLabelTable.h"
+#include "TextEventScheduler.h"
+#include "OSCStreamDecimator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/** Mirrors the plugin's MessageData, plus the send time embedded by the sender */
+struct MessageData
+{
+	int ttlLine;
+	bool state;
+	int streamIndex;
+	int durationMs;
+	unsigned long long arrivalTimeNs;
+	long long sentTimeNs;
+};
+
+typedef LockFreeQueue<MessageData> MessageQueue;
+
+const int MESSAGE_QUEUE_SIZE = 4096;
+
+long long steadyNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Builds a "/ttl line state sentTime" message into buffer, returns its size */
+std::size_t buildMessage(char* buffer, std::size_t capacity, int line, int state, long long sentTimeNs)
+{
+	osc::OutboundPacketStream packet(buffer, capacity);
+	packet << osc::BeginMessage("/ttl")
+		   << (osc::int32) line << (osc::int32) state << (osc::int64) sentTimeNs
+		   << osc::EndMessage;
+	return packet.Size();
+}
+
+/** Same decoding steps as OSCServer::routeMessage(), pushing into the queue */
+class PipelineListener : public osc::OscPacketListener
+{
+public:
+	PipelineListener(MessageQueue& queue) : m_queue(queue)
+	{
+		OSCRoute route;
+		route.address = "/ttl";
+		m_routes.addRoute(route);
+		m_routes.compile();
+	}
+
+	void ProcessMessage(const osc::ReceivedMessage& message, const IpEndpointName&) override
+	{
+		m_routes.dispatch(message.AddressPattern(), [&](const OSCRoute& route)
+		{
+			osc::int32 line = route.ttlLine;
+			osc::int32 state = 1;
+			osc::int64 sentTimeNs = 0;
+
+			if (!osc::DecodeArguments(message, line, state, sentTimeNs))
+				return;
+
+			MessageData data;
+			data.ttlLine = line;
+			data.state = state != 0;
+			data.streamIndex = route.streamIndex;
+			data.durationMs = route.durationMs;
+			data.arrivalTimeNs = PacketArrivalTime();
+			data.sentTimeNs = sentTimeNs;
+
+			m_queue.push(data);
+		});
+	}
+
+private:
+	MessageQueue& m_queue;
+	OSCRouteTable m_routes;
+};
+
+void benchmarkParse(long iterations)
+{
+	char buffer[256];
+	std::size_t size = buildMessage(buffer, sizeof(buffer), 3, 1, 123456789);
+
+	long long checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+	{
+		osc::ReceivedPacket packet(buffer, (osc::osc_bundle_element_size_t) size);
+		osc::ReceivedMessage message(packet);
+		osc::ReceivedMessageArgumentStream args = message.ArgumentStream();
+
+		osc::int32 line, state;
+		osc::int64 sentTimeNs;
+		args >> line >> state >> sentTimeNs >> osc::EndMessage;
+
+		checksum += line + state + sentTimeNs;
+	}
+
+	double seconds = secondsSince(start);
+
+	std::printf("parse     %12.0f messages/s  %8.1f ns/message  (checksum %lld)\n",
+				iterations / seconds, seconds * 1e9 / iterations, checksum & 0xff);
+
+	checksum = 0;
+	start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+	{
+		osc::ReceivedPacket packet(buffer, (osc::osc_bundle_element_size_t) size);
+		osc::ReceivedMessage message(packet);
+
+		osc::int32 line, state;
+		osc::int64 sentTimeNs;
+
+		if (osc::DecodeArguments(message, line, state, sentTimeNs))
+			checksum += line + state + sentTimeNs;
+	}
+
+	seconds = secondsSince(start);
+
+	std::printf("decode    %12.0f messages/s  %8.1f ns/message  (checksum %lld)\n",
+				iterations / seconds, seconds * 1e9 / iterations, checksum & 0xff);
+}
+
+void benchmarkMalformed(long iterations)
+{
+	char buffer[256];
+	std::size_t size = buildMessage(buffer, sizeof(buffer), 3, 1, 123456789);
+
+	// drop the last argument: the type tags promise more data than the message holds
+	const osc::osc_bundle_element_size_t truncatedSize = (osc::osc_bundle_element_size_t) size - 8;
+
+	long rejected = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+	{
+		try
+		{
+			osc::ReceivedMessage message(osc::ReceivedPacket(buffer, truncatedSize));
+		}
+		catch (const osc::MalformedMessageException&)
+		{
+			rejected++;
+		}
+	}
+
+	double throwingSeconds = secondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+	{
+		const char* error = 0;
+		osc::ReceivedMessage message(osc::ReceivedPacket(buffer, truncatedSize), error);
+		rejected += error != 0;
+	}
+
+	double nonThrowingSeconds = secondsSince(start);
+
+	std::printf("malformed %12.0f rejects/s   %8.1f ns/reject   (exceptions: %.1f ns/reject, %ld rejected)\n",
+				iterations / nonThrowingSeconds, nonThrowingSeconds * 1e9 / iterations,
+				throwingSeconds * 1e9 / iterations, rejected);
+}
+
+void benchmarkRoute(long iterations)
+{
+	OSCRouteTable routes;
+	routes.addRoutes("/ttl; /reward line=2; /light/on line=3 mode=on; /light/off line=3 mode=off");
+	routes.compile();
+
+	const char* patterns[] = { "/ttl", "/reward", "/light/on", "/light/*", "/nomatch" };
+
+	long matched = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+		matched += routes.dispatch(patterns[i % 5], [](const OSCRoute&) {});
+
+	double seconds = secondsSince(start);
+
+	std::printf("route     %12.0f lookups/s   %8.1f ns/lookup   (%ld routes matched)\n",
+				iterations / seconds, seconds * 1e9 / iterations, matched);
+}
+
+void benchmarkQueue(long iterations)
+{
+	MessageQueue queue(MESSAGE_QUEUE_SIZE);
+	MessageData data = {};
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::thread producer([&]()
+	{
+		MessageData element = {};
+
+		for (long i = 0; i < iterations; i++)
+		{
+			element.ttlLine = int(i);
+			while (!queue.push(element))
+				std::this_thread::yield();
+		}
+	});
+
+	long popped = 0;
+	long outOfOrder = 0;
+
+	while (popped < iterations)
+	{
+		if (queue.pop(data))
+		{
+			outOfOrder += data.ttlLine != int(popped);
+			popped++;
+		}
+		else
+			std::this_thread::yield();
+	}
+
+	producer.join();
+	double seconds = secondsSince(start);
+
+	std::printf("queue     %12.0f messages/s  %8.1f ns/message  (%ld out of order, %lld full retries)\n",
+				iterations / seconds, seconds * 1e9 / iterations, outOfOrder,
+				(long long) queue.getDroppedCount());
+}
+
+/** A message handed over as a view of its packet slab, as for routes that keep their messages */
+struct SlabMessage
+{
+	osc::ReceivedMessage message;
+	int slab = -1;
+};
+
+void benchmarkSlabs(long iterations)
+{
+	LockFreeQueue<SlabMessage> queue(MESSAGE_QUEUE_SIZE);
+	PacketSlabPool pool(1024, 2048);
+
+	std::atomic<long> poolFull { 0 };
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::thread producer([&]()
+	{
+		char buffer[256];
+		SlabMessage element;
+
+		for (long i = 0; i < iterations; i++)
+		{
+			std::size_t size = buildMessage(buffer, sizeof(buffer), int(i), 1, i);
+
+			// the listener copies the datagram out of the receive buffer once
+			int slab;
+			while ((slab = pool.acquire(buffer, (int) size)) < 0)
+			{
+				poolFull.fetch_add(1, std::memory_order_relaxed);
+				std::this_thread::yield();
+			}
+
+			const char* error = nullptr;
+			osc::ReceivedPacket packet(pool.getData(slab), (int) size, error);
+			element.message = osc::ReceivedMessage(packet, error);
+			element.slab = slab;
+
+			while (!queue.push(element))
+				std::this_thread::yield();
+		}
+	});
+
+	long popped = 0;
+	long mismatched = 0;
+	SlabMessage data;
+
+	while (popped < iterations)
+	{
+		if (queue.pop(data))
+		{
+			osc::int32 line = -1, state = 0;
+			osc::int64 sequence = -1;
+
+			mismatched += !osc::DecodeArguments(data.message, line, state, sequence) || line != int(popped);
+			pool.release(data.slab);
+			popped++;
+		}
+		else
+			std::this_thread::yield();
+	}
+
+	producer.join();
+	double seconds = secondsSince(start);
+
+	std::printf("slabs     %12.0f messages/s  %8.1f ns/message  (%ld mismatched, %ld pool full retries, %d in use)\n",
+				iterations / seconds, seconds * 1e9 / iterations, mismatched, poolFull.load(), pool.getNumInUse());
+}
+
+void benchmarkValues(long iterations, bool interpolate)
+{
+	const int numChannels = 16;
+	const int blockSize = 1024;
+	const int updateInterval = 30; // 1 kHz at 30 kHz
+	const long numBlocks = std::max(1L, iterations / 2000);
+
+	OSCValueWriter writer;
+	writer.setNumChannels(numChannels, 30000);
+
+	std::vector<float> data(numChannels * blockSize);
+	std::vector<float*> channels;
+
+	for (int channel = 0; channel < numChannels; channel++)
+		channels.push_back(data.data() + channel * blockSize);
+
+	long mismatched = 0;
+	long long nextUpdate = 0;
+	double writeSeconds = 0.0;
+
+	for (long block = 0; block < numBlocks; block++)
+	{
+		const long long startSampleNum = block * blockSize;
+
+		// each update's value is its own sample number, so the expected output is known
+		for (; nextUpdate < startSampleNum + blockSize; nextUpdate += updateInterval)
+		{
+			for (int channel = 0; channel < numChannels; channel++)
+				writer.schedule(nextUpdate, channel, float(nextUpdate), interpolate);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		writer.write(channels.data(), startSampleNum, blockSize);
+		writeSeconds += secondsSince(start);
+
+		// held: the last update; interpolated: one update period behind
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			for (int i = 0; i < blockSize; i++)
+			{
+				long long sampleNum = startSampleNum + i;
+				long long expected = interpolate ? std::max(0LL, sampleNum - updateInterval)
+												 : sampleNum - sampleNum % updateInterval;
+
+				mismatched += std::abs(channels[channel][i] - float(expected)) > 0.01f;
+			}
+		}
+	}
+
+	const double samples = double(numBlocks) * blockSize * numChannels;
+
+	std::printf("values    %12.0f samples/s   %8.2f ns/sample   (%s, %ld mismatched, %llu dropped)\n",
+				samples / writeSeconds, writeSeconds * 1e9 / samples, interpolate ? "linear" : "hold",
+				mismatched, (unsigned long long) writer.getDroppedCount());
+}
+
+void benchmarkLabels(long iterations)
+{
+	const int numLabels = 64;
+
+	OSCLabelTable labels;
+	TextEventScheduler scheduler;
+
+	std::vector<std::string> texts;
+
+	for (int i = 0; i < numLabels; i++)
+		texts.push_back("condition_" + std::to_string(i * 7919));
+
+	std::vector<int> ids(numLabels, -1);
+	long mismatched = 0;
+	long added = 0;
+
+	const double values[2] = { 1.0, 2.0 };
+	PendingTextEvent event;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (long i = 0; i < iterations; i++)
+	{
+		const int index = int(i % numLabels);
+		bool isNew;
+
+		int id = labels.intern(texts[index].c_str(), isNew);
+
+		if (isNew)
+		{
+			ids[index] = id;
+			added++;
+		}
+
+		mismatched += id != ids[index];
+
+		// one event per message, emitted in the same block
+		scheduler.schedule(i, id, values, 2);
+		scheduler.popEventBefore(i + 1, event);
+		mismatched += event.label != id;
+	}
+
+	double seconds = secondsSince(start);
+
+	for (int i = 0; i < numLabels; i++)
+		mismatched += texts[i] != labels.getText(ids[i]);
+
+	std::printf("labels    %12.0f messages/s  %8.1f ns/message  (%ld labels added, %ld mismatched, %llu dropped)\n",
+				iterations / seconds, seconds * 1e9 / iterations, added, mismatched,
+				(unsigned long long) scheduler.getDroppedCount());
+}
+
+enum StreamPacking { PACK_FLOATS, PACK_ARRAY, PACK_BLOB };
+
+void benchmarkStream(long iterations, StreamPacking packing)
+{
+	const int numChannels = 32;
+	const int blockSize = 1024;
+	const int decimation = 100;   // 30 kHz to 300 Hz
+	const int framesPerPacket = 10;
+	const long numBlocks = std::max(1L, iterations / 1000);
+
+	OSCStreamDecimator decimator;
+	decimator.setup(numChannels, decimation, framesPerPacket);
+
+	// each channel is a ramp, so every average is known
+	std::vector<float> data(numChannels * blockSize);
+	std::vector<const float*> channels;
+
+	for (int channel = 0; channel < numChannels; channel++)
+		channels.push_back(data.data() + channel * blockSize);
+
+	std::vector<char> buffer(128 + 5 * numChannels * framesPerPacket);
+
+	long numPackets = 0;
+	long mismatched = 0;
+	double seconds = 0.0;
+	double packSeconds = 0.0;
+
+	for (long block = 0; block < numBlocks; block++)
+	{
+		const long long startSampleNum = block * blockSize;
+
+		for (int channel = 0; channel < numChannels; channel++)
+			for (int i = 0; i < blockSize; i++)
+				data[channel * blockSize + i] = float((startSampleNum + i) % 100000) + channel;
+
+		auto start = std::chrono::steady_clock::now();
+
+		decimator.process(channels.data(), blockSize, startSampleNum, [&](const float* frames, int64_t firstSampleNum)
+		{
+			const int numValues = numChannels * framesPerPacket;
+
+			auto packStart = std::chrono::steady_clock::now();
+
+			osc::OutboundPacketStream packet(buffer.data(), buffer.size());
+			packet << osc::BeginMessage("/oscevents/data")
+				   << (osc::int32) 0 << (osc::int64) firstSampleNum << 300.0f
+				   << (osc::int32) numChannels << (osc::int32) framesPerPacket;
+
+			if (packing == PACK_FLOATS)
+			{
+				for (int i = 0; i < numValues; i++)
+					packet << frames[i];
+			}
+			else if (packing == PACK_ARRAY)
+				packet << osc::Float32Array(frames, numValues);
+			else
+				packet << osc::Float32Blob(frames, numValues);
+
+			packet << osc::EndMessage;
+
+			packSeconds += secondsSince(packStart);
+			numPackets++;
+
+			// the check is not timed
+			auto checkStart = std::chrono::steady_clock::now();
+
+			const char* error = nullptr;
+			osc::ReceivedPacket received(packet.Data(), (int) packet.Size(), error);
+			osc::ReceivedMessage message(received, error);
+
+			if (error != nullptr)
+			{
+				mismatched++;
+				seconds -= secondsSince(checkStart);
+				return;
+			}
+
+			auto argument = message.ArgumentsBegin();
+			for (int i = 0; i < 5; i++)
+				++argument;
+
+			const char* blob = nullptr;
+			osc::osc_bundle_element_size_t blobSize = 0;
+
+			if (packing == PACK_BLOB)
+				argument->AsBlobUnchecked((const void*&) blob, blobSize);
+
+			for (int frame = 0; frame < framesPerPacket; frame++)
+			{
+				long long first = firstSampleNum + frame * decimation;
+
+				for (int channel = 0; channel < numChannels; channel++)
+				{
+					float value;
+
+					if (packing == PACK_BLOB)
+					{
+						uint32_t word = uint32_t((uint8_t) blob[0]) << 24 | uint32_t((uint8_t) blob[1]) << 16
+									  | uint32_t((uint8_t) blob[2]) << 8 | uint32_t((uint8_t) blob[3]);
+						std::memcpy(&value, &word, 4);
+						blob += 4;
+					}
+					else
+						value = (argument++)->AsFloatUnchecked();
+
+					// the mean of a ramp is its midpoint, unless it wraps
+					double expected = (first % 100000) + (decimation - 1) / 2.0 + channel;
+
+					if ((first % 100000) + decimation <= 100000)
+						mismatched += std::abs(value - expected) > 0.01 * (1 + expected * 1e-4);
+				}
+			}
+
+			seconds -= secondsSince(checkStart);
+		});
+
+		seconds += secondsSince(start);
+	}
+
+	const char* name = packing == PACK_FLOATS ? "floats" : (packing == PACK_ARRAY ? "array" : "blob");
+
+	const double samples = numBlocks * (double) blockSize * numChannels;
+
+	std::printf("stream    %12.0f samples/s   %8.2f ns/sample   (%s, %.0f ns/packet packing, %ld packets, %ld mismatched)\n",
+				samples / seconds, seconds * 1e9 / samples, name,
+				packSeconds * 1e9 / std::max(1L, numPackets), numPackets, mismatched);
+}
+
+void printPercentiles(const char* name, std::vector<long long>& samples)
+{
+	if (samples.empty())
+	{
+		std::printf("%-22s no samples\n", name);
+		return;
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	auto at = [&](double quantile)
+	{
+		std::size_t index = std::min(samples.size() - 1, (std::size_t) (quantile * samples.size()));
+		return samples[index] * 1e-3;
+	};
+
+	std::printf("%-22s p50 %8.1f  p90 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f us\n",
+				name, at(0.5), at(0.9), at(0.99), at(0.999), samples.back() * 1e-3);
+}
+
+void benchmarkLoopback(long numPackets, double rate, int blockMicroseconds, int port)
+{
+	MessageQueue queue(MESSAGE_QUEUE_SIZE);
+	PipelineListener listener(queue);
+
+	UdpListeningReceiveSocket socket(IpEndpointName("127.0.0.1", port), &listener);
+	socket.SetReceiveBatchSize(32);
+
+	std::thread receiver([&]() { socket.Run(); });
+
+	std::vector<long long> endToEnd;
+	std::vector<long long> kernelToProcess;
+	LatencyHistogram kernelToProcessHistogram; // what the plugin reports, checked against the exact values
+	endToEnd.reserve(numPackets);
+	kernelToProcess.reserve(numPackets);
+
+	std::atomic<bool> sending { true };
+
+	// mock of OSCEventsNode::process()
+	std::thread processor([&]()
+	{
+		MessageData data;
+
+		while (sending.load() || !queue.isEmpty())
+		{
+			while (queue.pop(data))
+			{
+				endToEnd.push_back(steadyNanoseconds() - data.sentTimeNs);
+
+				if (data.arrivalTimeNs != 0)
+				{
+					kernelToProcess.push_back((long long) (GetPacketClockNanoseconds() - data.arrivalTimeNs));
+					kernelToProcessHistogram.record((uint64_t) kernelToProcess.back());
+				}
+			}
+
+			if (blockMicroseconds > 0)
+				std::this_thread::sleep_for(std::chrono::microseconds(blockMicroseconds));
+			else
+				std::this_thread::yield();
+		}
+	});
+
+	UdpTransmitSocket sender(IpEndpointName("127.0.0.1", port));
+	char buffer[256];
+
+	auto start = std::chrono::steady_clock::now();
+	const double interval = rate > 0 ? 1.0 / rate : 0.0;
+
+	for (long i = 0; i < numPackets; i++)
+	{
+		// sleep rather than spin, so the sender does not compete with the listener for a core
+		if (interval > 0)
+			std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(i * interval)));
+
+		std::size_t size = buildMessage(buffer, sizeof(buffer), int(i % 8), 1, steadyNanoseconds());
+		sender.Send(buffer, size);
+	}
+
+	double seconds = secondsSince(start);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	sending.store(false);
+	processor.join();
+
+	socket.AsynchronousBreak();
+	receiver.join();
+
+	std::printf("loopback  %ld sent at %.0f/s, %zu processed, %lld dropped by the queue\n",
+				numPackets, numPackets / seconds, endToEnd.size(), (long long) queue.getDroppedCount());
+
+	printPercentiles("  send -> process()", endToEnd);
+	printPercentiles("  kernel -> process()", kernelToProcess);
+
+	if (kernelToProcessHistogram.getCount() > 0)
+	{
+		auto at = [&](double quantile) { return kernelToProcessHistogram.getValueAtPercentile(quantile) * 1e-3; };
+
+		std::printf("%-22s p50 %8.1f  p90 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f us\n",
+					"  (histogram)", at(0.5), at(0.9), at(0.99), at(0.999),
+					kernelToProcessHistogram.getMax() * 1e-3);
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	long iterations = 2000000;
+	long numPackets = 20000;
+	double rate = 10000;
+	int blockMicroseconds = 0;
+	int port = 47100;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0)
+			iterations = std::atol(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--packets") == 0)
+			numPackets = std::atol(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--rate") == 0)
+			rate = std::atof(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--block-us") == 0)
+			blockMicroseconds = std::atoi(argv[i + 1]);
+		else if (std::strcmp(argv[i], "--port") == 0)
+			port = std::atoi(argv[i + 1]);
+	}
+
+	benchmarkParse(iterations);
+	benchmarkMalformed(iterations / 10);
+	benchmarkRoute(iterations);
+	benchmarkQueue(iterations);
+	benchmarkSlabs(iterations);
+	benchmarkValues(iterations, false);
+	benchmarkValues(iterations, true);
+	benchmarkLabels(iterations);
+	benchmarkStream(iterations, PACK_FLOATS);
+	benchmarkStream(iterations, PACK_ARRAY);
+	benchmarkStream(iterations, PACK_BLOB);
+
+	try
+	{
+		benchmarkLoopback(numPackets, rate, blockMicroseconds, port);
+	}
+	catch (const std::exception& e)
+	{
+		std::printf("loopback  failed: %s\n", e.what());
+		return 1;
+	}
+
+	return 0;
+}
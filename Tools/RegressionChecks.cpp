@@ -0,0 +1,183 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Regression checks for the plugin sources that do not depend on
+	plugin-GUI. Exits with a non-zero status if any check fails; run
+	through ctest or directly.
+
+	Usage: osc-io-checks
+*/
+
+#include "OSCAddressMatcher.h"
+#include "TTLEventScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::printf("FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+/** Returns the sorted indices of the addresses matched by a pattern */
+std::vector<int> matches(OSCAddressMatcher& matcher, const char* pattern)
+{
+	std::vector<int> indices;
+	matcher.match(pattern, [&](int index) { indices.push_back(index); });
+	std::sort(indices.begin(), indices.end());
+	return indices;
+}
+
+void checkMatcher()
+{
+	OSCAddressMatcher matcher;
+	const int stimulus = matcher.addAddress("/experiment/stimulus_onset_condition");
+	const int ttl = matcher.addAddress("/ttl");
+	const int ttl2 = matcher.addAddress("/ttl2");
+	const int longSegment = matcher.addAddress("/" + std::string(60, 'a'));
+	matcher.compile();
+
+	check(matches(matcher, "/ttl") == std::vector<int>({ ttl }), "literal address");
+	check(matches(matcher, "/ttl?") == std::vector<int>({ ttl2 }), "'?' wildcard");
+	check(matches(matcher, "/ttl*") == std::vector<int>({ ttl, ttl2 }), "'*' wildcard");
+	check(matches(matcher, "/t[st]l[0-9]") == std::vector<int>({ ttl2 }), "bracket expression");
+	check(matches(matcher, "/{ttl,ttl2}") == std::vector<int>({ ttl, ttl2 }), "alternatives");
+	check(matches(matcher, "/*/stim*_{onset,offset}_*") == std::vector<int>({ stimulus }), "mixed wildcards");
+	check(matches(matcher, "/*a*a*a*a*a*a*a") == std::vector<int>({ longSegment }), "repeated '*'");
+	check(matches(matcher, "/*a*a*a*a*a*a*ab").empty(), "repeated '*' without a match");
+	check(matches(matcher, "/ttl*/x").empty(), "'*' does not cross '/'");
+
+	// patterns that used to backtrack exponentially must stay cheap
+	std::string starQuestion = "/";
+	for (int i = 0; i < 14; i++)
+		starQuestion += "*?";
+
+	std::string manyStars = "/";
+	for (int i = 0; i < 30; i++)
+		manyStars += "*a";
+	manyStars += "b";
+
+	const char* pathological[] = {
+		"/*a*a*a*a*a*a*ab",
+		starQuestion.c_str(),
+		manyStars.c_str(),
+		"/*?*?*?*?*?*?*?*?*?*?*?*?*?*?/stimulus_onset_condition"
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int repeat = 0; repeat < 100; repeat++)
+	{
+		for (const char* pattern : pathological)
+			matches(matcher, pattern);
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("matcher   400 pathological patterns in %.2f ms\n", seconds * 1e3);
+	check(seconds < 0.5, "pathological patterns match in bounded time");
+
+	std::string tooManyWildcards = "/";
+	for (int i = 0; i <= MAX_PATTERN_WILDCARDS; i++)
+		tooManyWildcards += "?";
+
+	check(matches(matcher, tooManyWildcards.c_str()).empty(), "patterns with too many wildcards are rejected");
+}
+
+/** Pops every edge before endSampleNumber as "on@N" / "off@N" */
+std::vector<std::string> popEdges(TTLEventScheduler& scheduler, int64_t endSampleNumber)
+{
+	std::vector<std::string> edges;
+	TTLEdge edge;
+
+	while (scheduler.popEdgeBefore(endSampleNumber, edge))
+		edges.push_back((edge.state ? "on@" : "off@") + std::to_string(edge.sampleNumber));
+
+	return edges;
+}
+
+void checkScheduler()
+{
+	TTLEventScheduler scheduler;
+
+	// overlapping pulses: the line stays high until the last one ends
+	scheduler.schedulePulse(100, 300, 0);
+	scheduler.schedulePulse(200, 250, 0);
+	check(popEdges(scheduler, 1000) == std::vector<std::string>({ "on@100", "on@200", "off@300" }),
+		  "overlapping pulses end with the last of them");
+
+	// a future-tagged pulse scheduled after a current one must not suppress its end
+	scheduler.clear();
+	scheduler.schedulePulse(100, 200, 0);
+	scheduler.schedulePulse(1000, 1100, 0);
+	check(popEdges(scheduler, 2000) == std::vector<std::string>({ "on@100", "off@200", "on@1000", "off@1100" }),
+		  "out-of-order pulses keep their own ends");
+
+	// the same, with the later pulse scheduled first and the edges popped block by block
+	scheduler.clear();
+	scheduler.schedulePulse(1000, 1100, 0);
+	scheduler.schedulePulse(100, 200, 0);
+	std::vector<std::string> edges;
+	for (int64_t block = 128; block <= 2048; block += 128)
+	{
+		for (const std::string& edge : popEdges(scheduler, block))
+			edges.push_back(edge);
+	}
+	check(edges == std::vector<std::string>({ "on@100", "off@200", "on@1000", "off@1100" }),
+		  "pulses scheduled latest first keep their own ends");
+
+	// pulses on other lines are independent
+	scheduler.clear();
+	scheduler.schedulePulse(100, 300, 0);
+	scheduler.schedulePulse(150, 200, 1);
+	check(popEdges(scheduler, 1000) == std::vector<std::string>({ "on@100", "on@150", "off@200", "off@300" }),
+		  "pulses on different lines do not interact");
+}
+
+}
+
+int main()
+{
+	checkMatcher();
+	checkScheduler();
+
+	if (failures > 0)
+	{
+		std::printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	std::printf("all checks passed\n");
+	return 0;
+}
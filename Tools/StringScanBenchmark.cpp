@@ -0,0 +1,170 @@
+/*
+------------------------------------------------------------------
+
+This file is part of the Open Ephys GUI
+Copyright (C) 2022 Open Ephys
+
+------------------------------------------------------------------
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	Compares the OSC string scanning kernels (scalar, SSE2, AVX2, NEON)
+	on address patterns of realistic lengths, and measures the resulting
+	ReceivedMessage parse rate. Every kernel is first checked against the
+	scalar one on random buffers.
+
+	Usage: string-scan-benchmark [--iterations N]
+*/
+
+#include <oscpack/osc/OscOutboundPacketStream.h>
+#include <oscpack/osc/OscReceivedElements.h>
+#include <oscpack/osc/OscStringScan.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Kernel { osc::StringScanKernel id; const char* name; };
+
+const Kernel kernels[] = {
+	{ osc::SCALAR_STRING_SCAN, "scalar" },
+	{ osc::SSE2_STRING_SCAN, "sse2" },
+	{ osc::AVX2_STRING_SCAN, "avx2" },
+	{ osc::NEON_STRING_SCAN, "neon" }
+};
+
+bool checkKernels()
+{
+	std::mt19937 random(42);
+	std::vector<char> buffer(256);
+	bool ok = true;
+
+	for (int trial = 0; trial < 100000; trial++)
+	{
+		int size = 4 * (1 + random() % 64);
+
+		// mostly non-zero bytes, so strings of every length occur
+		for (int i = 0; i < size; i++)
+			buffer[i] = (random() % 48 == 0) ? 0 : char('a' + random() % 26);
+
+		const char* expected = osc::FindStr4EndScalar(buffer.data(), buffer.data() + size);
+
+		for (const Kernel& kernel : kernels)
+		{
+			if (!osc::IsStringScanKernelAvailable(kernel.id))
+				continue;
+
+			if (osc::FindStr4EndWithKernel(kernel.id, buffer.data(), buffer.data() + size) != expected)
+			{
+				std::printf("%s disagrees with scalar (size %d)\n", kernel.name, size);
+				ok = false;
+			}
+		}
+	}
+
+	return ok;
+}
+
+std::string makeAddress(int length)
+{
+	// e.g. /rig1/stim/led/..., as sent by behaviour control software
+	static const char* const parts[] = { "/rig1", "/stim", "/led", "/left", "/pulse", "/trial" };
+
+	std::string address;
+	for (int i = 0; (int) address.size() < length; i++)
+		address += parts[i % 6];
+
+	address.resize(length);
+	return address;
+}
+
+double nanosecondsPer(long iterations, std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	long iterations = 5000000;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0)
+			iterations = std::atol(argv[i + 1]);
+	}
+
+	if (!checkKernels())
+		return 1;
+
+	const osc::StringScanKernel selected = osc::SelectedStringScanKernel();
+
+	std::printf("selected kernel: %s\n\n", kernels[selected].name);
+	std::printf("%-8s %-8s %16s %20s\n", "address", "kernel", "scan ns/address", "parse ns/message");
+
+	const int lengths[] = { 4, 12, 24, 40, 64, 128 };
+	long sink = 0;
+
+	for (int length : lengths)
+	{
+		std::string address = makeAddress(length);
+
+		char buffer[512];
+		osc::OutboundPacketStream packet(buffer, sizeof(buffer));
+		packet << osc::BeginMessage(address.c_str()) << (osc::int32) 1 << (osc::int32) 1 << osc::EndMessage;
+
+		const char* begin = packet.Data();
+		const char* end = begin + packet.Size();
+		const osc::osc_bundle_element_size_t size = (osc::osc_bundle_element_size_t) packet.Size();
+
+		for (const Kernel& kernel : kernels)
+		{
+			if (!osc::SetStringScanKernel(kernel.id))
+				continue;
+
+			auto start = std::chrono::steady_clock::now();
+
+			for (long i = 0; i < iterations; i++)
+				sink += osc::FindStr4EndBounded(begin, end) - begin;
+
+			double scanNs = nanosecondsPer(iterations, start);
+
+			// full ReceivedMessage validation: address, type tags and arguments
+			start = std::chrono::steady_clock::now();
+
+			for (long i = 0; i < iterations; i++)
+			{
+				osc::ReceivedMessage message(osc::ReceivedPacket(begin, size));
+				sink += message.ArgumentCount();
+			}
+
+			std::printf("%-8d %-8s %16.2f %20.2f\n", length, kernel.name, scanNs, nanosecondsPer(iterations, start));
+		}
+	}
+
+	osc::SetStringScanKernel(selected);
+
+	// keeps the loops from being optimised away
+	return sink == 42 ? 2 : 0;
+}